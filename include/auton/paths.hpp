@@ -0,0 +1,23 @@
+#pragma once
+#include "localization/pose.hpp"
+#include "motion/spline.hpp"
+
+// Baked auton routes, shared by the routines and the native sim
+namespace paths {
+  // The 24 in square from start: (+24, 0), (+24, +24), (0, +24). Each
+  // corner is crossed on the diagonal at zero curvature, so the turns
+  // happen either side of it and stay wide enough to follow.
+  constexpr auto skills(const Pose& start) {
+    constexpr double LEG_SPEED = 16.0;        // in per unit t leaving the start, arriving at the end
+    constexpr double CORNER_SPEED = 14.14;    // 20 in per unit t along the diagonal
+    constexpr Waypoint NONE{0.0, 0.0};
+    const Waypoint s{start.x, start.y};
+    const Waypoint corner1{start.x + 24.0, start.y};
+    const Waypoint corner2{start.x + 24.0, start.y + 24.0};
+    const Waypoint end{start.x, start.y + 24.0};
+    return spline::bake<48>(spline::Chain<spline::QuinticHermite, 3>{{
+      {s, {LEG_SPEED, 0.0}, NONE, corner1, {CORNER_SPEED, CORNER_SPEED}, NONE},
+      {corner1, {CORNER_SPEED, CORNER_SPEED}, NONE, corner2, {-CORNER_SPEED, CORNER_SPEED}, NONE},
+      {corner2, {-CORNER_SPEED, CORNER_SPEED}, NONE, end, {-LEG_SPEED, 0.0}, NONE}}});
+  }
+}
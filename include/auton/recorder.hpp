@@ -0,0 +1,57 @@
+#pragma once
+#include "drive/drive.hpp"
+#include "localization/odom.hpp"
+#include <cstdint>
+
+// Driver record and replay: capture a route at full driver speed in
+// opcontrol, play it back in autonomous.
+//
+// Each 100 Hz frame holds the drive voltages as requested from setVoltage()
+// (before slew, which replay applies again) and one bit per mechanism. Frames
+// are delta-encoded into a buffer sized for the worst case, so recording
+// never allocates and never runs out before MAX_SECONDS:
+//
+//   u8 flags             bit0 left changed, bit1 right changed, bit2 mechanisms changed
+//   varint dLeft         zigzag, 10 mV units (if bit0)
+//   varint dRight        (if bit1)
+//   u8 mechanisms        (if bit2)
+//
+// Odom's pose is kept every POSE_EVERY frames. Replay resets odom to the
+// recorded start and, with correctDrift, trims the voltages toward the
+// recorded pose trace so slip and battery sag don't add up over a run.
+//
+// The SD file is "ZRPL" u16 version u16 rateMs u32 frames u32 streamBytes,
+// f32 start x/y/theta, the stream, then f32 x/y/theta per pose key.
+namespace recorder {
+  constexpr std::uint32_t RATE_MS = 10;
+  constexpr int MAX_SECONDS = 75;            // skills plus setup
+  constexpr int MAX_FRAMES = MAX_SECONDS * 1000 / RATE_MS;
+  constexpr int POSE_EVERY = 10;             // 10 Hz is plenty for drift
+
+  // Clears the buffer; pose is where odom has the robot now. False while
+  // already recording, saving, loading or replaying
+  bool start(const Pose& pose);
+  // One opcontrol tick. False once stopped or full (recording stops itself)
+  bool record(int leftMv, int rightMv, std::uint8_t mechanisms, const Pose& pose);
+  void stop();
+  bool recording();
+  int frames();          // recorded or loaded
+
+  // Blocking SD write/read; save from a low-priority task, not the drive loop.
+  // Both hold the buffer, so start() waits for them. load() rejects a file
+  // whose stream doesn't decode to exactly its frame count.
+  bool save(const char* path = "/usd/replay.bin");
+  bool load(const char* path = "/usd/replay.bin");
+
+  struct ReplaySettings {
+    bool correctDrift = true;
+    double alongMvPerIn = 150.0;         // recorded pose ahead/behind
+    double headingMvPerRad = 3000.0;     // per side
+    double crossRadPerIn = 0.06;         // steer back onto the trace
+    double maxCorrectionMv = 3000.0;
+    void (*mechanisms)(std::uint8_t bits) = nullptr;   // called when the bits change
+  };
+
+  // Blocks for the length of the recording, then stops the drive
+  void replay(Drive& drive, Odom& odom, const ReplaySettings& settings = ReplaySettings{});
+}
@@ -1,8 +1,14 @@
 #pragma once
+#include "motion/waypoint.hpp"
 
 namespace auton {
   void doNothing();
   void skills();
   void leftRush();
   void rightSafe();
+  void tuneDrive();   // autotune + save, not a match auton
+  void characterize(); // sysid + save, not a match auton
+  void replayDriver();  // last driver recording (opcontrol, B)
+
+  PathView skillsPath();  // field frame, for the selector preview
 }
@@ -0,0 +1,47 @@
+#pragma once
+#include "drive/drive.hpp"
+#include "localization/odom.hpp"
+#include "motion/motion.hpp"
+#include <cstdint>
+
+// Auton routes from a text file on the SD card, so a route change is an
+// edit and a card swap instead of a rebuild.
+//
+//   # comments and blank lines are ignored
+//   auton Left Rush          starts a route, named as shown in the selector
+//   reset 0 0 0              odom pose: x y headingDeg
+//   drive 36                 Drive::driveDistance, inches
+//   turn 45                  Drive::turnTo, degrees
+//   point 24 24              Motion::driveToPoint
+//   pose 24 24 90            Motion::driveToPose: x y headingDeg
+//   path 24 0 24 24 0 24     Motion::followPath from the current pose, x y pairs
+//   wait 250                 milliseconds
+//   intake 1                 mechanism bound with bindMechanism(), one value
+//
+// load() parses and validates the whole file once, into a flat array of
+// fixed-size instructions plus a pool of path points. Any error rejects the
+// file (with its line number in error()) so a typo can't surface mid-match.
+// run() is a switch over that array: no parsing, no allocation.
+namespace script {
+  constexpr int MAX_ROUTES = 8;
+  constexpr int MAX_INSTRS = 256;
+  constexpr int MAX_PATH_POINTS = 256;     // shared by every path op
+  constexpr int MAX_MECHANISMS = 8;
+
+  // Mechanisms must be bound before load() so names can be checked
+  bool bindMechanism(const char* name, void (*fn)(double value));
+
+  bool load(const char* path = "/usd/auton.txt");
+  const char* error();       // why the last load() failed, "" if it didn't
+
+  int routeCount();
+  const char* routeName(int route);
+
+  // Where a route goes, for the selector preview: dead-reckons the commands
+  // (each one assumed to land exactly) from reset, or (0, 0, 0) without one.
+  // Writes at most max points; returns how many.
+  int preview(int route, Waypoint* out, int max);
+
+  // Runs one route to completion; blocks like the built-in routines
+  void run(int route, Drive& drive, Motion& motion, Odom& odom);
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include "motion/waypoint.hpp"
 #include <cstddef>
 
 namespace auton_selector {
@@ -11,4 +12,10 @@ namespace auton_selector {
   bool isLocked();
   void setLocked(bool locked);
 
+  // For the touchscreen: every entry, built-in then scripted
+  int count();
+  int selectedIndex();
+  const char* nameAt(int i);
+  int preview(int i, Waypoint* out, int max);   // field-frame points, 0 if none
+  void request(int i);   // applied by the selector task unless locked
 }
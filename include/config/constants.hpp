@@ -1,9 +1,15 @@
 #pragma once
 #include <cmath>
+#include <cstdint>
 
 namespace constants {
   constexpr int MAX_VOLTAGE = 12000;
 
+  // Drive commands (feedforward, PID, driver) are millivolts at this battery
+  // voltage; Drive rescales them by the filtered battery reading
+  constexpr double NOMINAL_BATTERY_MV = 12000.0;
+  constexpr double BATTERY_FILTER_TAU_S = 0.5;
+
   constexpr double WHEEL_DIAMETER_IN = 2.75;
   constexpr double WHEEL_CIRCUMFERENCE_IN = WHEEL_DIAMETER_IN * M_PI;
 
@@ -19,4 +25,66 @@ namespace constants {
 
   // Measure later
   constexpr double TRACK_WIDTH_IN = 12.5;
+
+  // Drivetrain feedforward: mV, mV per in/s, mV per in/s^2 (starter, run sysid)
+  constexpr double DRIVE_KS = 600.0;
+  constexpr double DRIVE_KV = 185.0;   // 12000mV / ~65 in/s free speed
+  constexpr double DRIVE_KA = 26.0;
+
+  // Turning in place, per side: mV, mV per deg/s, mV per deg/s^2 (starter, run sysid)
+  constexpr double TURN_KS = 600.0;
+  constexpr double TURN_KV = 20.0;     // DRIVE_KV * (pi/180) * TRACK_WIDTH_IN/2
+  constexpr double TURN_KA = 2.5;
+
+  // turnTo profile limits (deg/s, deg/s^2, deg/s^3)
+  constexpr double TURN_MAX_VEL = 360.0;
+  constexpr double TURN_MAX_ACCEL = 1500.0;
+  constexpr double TURN_MAX_JERK = 15000.0;
+
+  // Default driveDistance profile limits (in/s, in/s^2, in/s^3; jerk 0 = trapezoid)
+  constexpr double DRIVE_MAX_VEL = 55.0;
+  constexpr double DRIVE_MAX_ACCEL = 150.0;
+  constexpr double DRIVE_MAX_JERK = 2000.0;
+
+  // Tracking wheels (rotation sensors on unpowered omnis), measured from the
+  // tracking center. Off until they're fitted: odom uses drive motor
+  // encoders + IMU, and falls back to those if a tracking sensor drops out.
+  constexpr bool USE_TRACKING_WHEELS = false;
+  constexpr double TRACKING_WHEEL_DIAMETER_IN = 2.0;
+  constexpr double TRACKING_LEFT_OFFSET_IN = 2.5;   // center -> left parallel wheel
+  constexpr double TRACKING_RIGHT_OFFSET_IN = 2.5;  // center -> right parallel wheel
+  constexpr double TRACKING_BACK_OFFSET_IN = 3.0;   // center -> perpendicular wheel (behind)
+
+  // GPS sensor, fused into Odom as an absolute correction. With it on, odom
+  // poses are field coordinates (inches from field center).
+  constexpr bool USE_GPS = false;
+  constexpr double GPS_X_OFFSET_IN = 0.0;       // sensor -> tracking center, sensor frame
+  constexpr double GPS_Y_OFFSET_IN = 0.0;
+  constexpr std::uint32_t GPS_LATENCY_MS = 40;  // fix age when read
+  constexpr double GPS_MAX_ERROR_IN = 2.0;      // ignore fixes the sensor rates worse
+
+  // Distance sensors for Monte Carlo localization against the field walls.
+  // Robot frame from the tracking center: x forward, y right, angle
+  // clockwise from forward. Order matches ports::DIST_*.
+  constexpr bool USE_MCL = false;
+  struct DistanceMount {
+    double xIn;
+    double yIn;
+    double angleDeg;
+  };
+  constexpr DistanceMount DISTANCE_MOUNTS[] = {
+    { 6.0,  0.0,    0.0},   // front
+    { 0.0, -6.0,  -90.0},   // left
+    { 0.0,  6.0,   90.0},   // right
+    {-6.0,  0.0,  180.0},   // back
+  };
+
+  // Match periods: Thermal budgets drive power to last to their end
+  constexpr std::uint32_t AUTON_MS = 15000;
+  constexpr std::uint32_t DRIVER_MS = 105000;
+  constexpr double THERMAL_WARN_S = 20.0;   // rumble when the model says throttle is closer
+
+  inline double trackingDegToInches(double sensor_deg) {
+    return sensor_deg / 360.0 * TRACKING_WHEEL_DIAMETER_IN * M_PI;
+  }
 }
@@ -11,4 +11,17 @@ namespace ports {
   constexpr int R3 = 6;
 
   constexpr int IMU = 7;
+
+  // Rotation sensors, negative = reversed
+  constexpr int TRACK_LEFT = 8;
+  constexpr int TRACK_RIGHT = 9;
+  constexpr int TRACK_BACK = 10;
+
+  constexpr int GPS = 11;
+
+  // Distance sensors for Mcl, same order as constants::DISTANCE_MOUNTS (0 = none)
+  constexpr int DIST_FRONT = 12;
+  constexpr int DIST_LEFT = 13;
+  constexpr int DIST_RIGHT = 14;
+  constexpr int DIST_BACK = 15;
 }
@@ -0,0 +1,57 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <memory>
+
+// Shared state between a motion running on its own task and the caller.
+// The running loop reports through motion_command::tick(); the caller
+// watches it through a MotionHandle.
+class MotionCommand {
+public:
+  std::atomic<bool> done{false};
+  std::atomic<bool> cancelRequested{false};
+  std::atomic<double> traveledIn{0.0};  // path length covered so far (0 for turns)
+  std::atomic<double> progress{0.0};    // 0..1 toward the target
+};
+
+class MotionHandle {
+public:
+  MotionHandle() = default;
+  explicit MotionHandle(std::shared_ptr<MotionCommand> cmd) : cmd(std::move(cmd)) {}
+
+  bool done() const;
+  double traveledIn() const;
+  double progress() const;
+
+  // Blocking helpers; all return early if the motion finishes or is cancelled
+  void wait() const;
+  void waitUntilDistance(double inches) const;
+  void waitUntilProgress(double frac) const;
+
+  // Ask the motion to stop; it drops to 0V on its next tick
+  void cancel() const;
+
+private:
+  std::shared_ptr<MotionCommand> cmd;
+};
+
+namespace motion_command {
+  // Runs fn on a new "Motion" task. Any async motion still running is
+  // cancelled and waited for first, so only one drives at a time.
+  MotionHandle start(std::function<void()> fn);
+
+  // Cancels the running async motion (if any) and waits for it to stop.
+  // Competition mode changes call it: killing the autonomous task doesn't
+  // stop the Motion task it started.
+  void cancelAll();
+
+  // Called at the top of every blocking motion. From any task but the
+  // running command's own it cancels that command first (cancelAll), so a
+  // blocking move never shares the drivetrain with an async one.
+  void claim();
+
+  // Called once per tick by every motion loop. On the task running an
+  // async command it reports progress to it and returns false once it was
+  // cancelled; on any other task it just returns true.
+  bool tick(double traveledIn, double progress);
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include "control/profiler.hpp"
+#include <cstdint>
+
+// Fixed-rate loop timing shared by every control loop.
+//
+// Usage:
+//   FixedRate rate("turnTo", 10);
+//   while (...) {
+//     ...
+//     const double dt = rate.wait();  // measured seconds since last wait()
+//   }
+//
+// wait() sleeps with delay_until, so compute time doesn't stretch the period.
+// Each loop name gets a slot in a fixed table with overrun/jitter stats, and
+// a profiler section of the same name timing the work between wait() calls.
+class FixedRate {
+public:
+  FixedRate(const char* name, std::uint32_t periodMs);
+
+  // Sleeps until the next tick, returns measured dt (seconds)
+  double wait();
+
+  double periodSec() const { return periodMs / 1000.0; }
+  std::uint32_t startMs() const { return firstMs; }
+  std::uint32_t elapsedMs() const;
+
+private:
+  int slot;
+  profiler::Section busy;
+  std::uint32_t periodMs;
+  std::uint32_t firstMs;
+  std::uint32_t prevMs;
+  std::uint64_t lastUs;
+};
+
+namespace executive {
+  constexpr int MAX_LOOPS = 16;
+
+  struct LoopStats {
+    const char* name;
+    std::uint32_t periodMs;
+    std::uint32_t ticks;
+    std::uint32_t overruns;     // ticks whose deadline had passed before wait()
+    double lastDtMs;
+    double meanJitterMs;        // mean |dt - period|
+    double maxJitterMs;
+  };
+
+  int count();
+  bool stats(int i, LoopStats& out);  // false if slot i is unused
+  void resetStats();
+}
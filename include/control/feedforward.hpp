@@ -0,0 +1,15 @@
+#pragma once
+#include <cmath>
+
+// Drivetrain voltage model: V = kS*sign(v) + kV*v + kA*a
+// Units: mV, mV per (in/s), mV per (in/s^2)
+struct Feedforward {
+  double kS;
+  double kV;
+  double kA;
+
+  double calc(double vel, double acc) const {
+    const double sgn = (vel > 0) - (vel < 0);
+    return kS * sgn + kV * vel + kA * acc;
+  }
+};
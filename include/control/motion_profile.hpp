@@ -0,0 +1,41 @@
+#pragma once
+#include <array>
+
+// Limits for one profiled move. maxJerk <= 0 gives a trapezoidal profile,
+// otherwise a jerk-limited S-curve. Units are whatever the caller uses for
+// distance (inches for the drive), per second.
+struct ProfileConstraints {
+  double maxVel;
+  double maxAccel;
+  double maxJerk{0.0};
+};
+
+struct ProfileState {
+  double pos;
+  double vel;
+  double acc;
+};
+
+// Time-optimal rest-to-rest profile over a signed distance. Short moves that
+// can't reach maxVel (or maxAccel) get the largest peak that still fits.
+class MotionProfile {
+public:
+  MotionProfile(double distance, const ProfileConstraints& limits);
+
+  ProfileState sample(double t) const;  // clamps to [0, duration]
+  double duration() const { return total; }
+
+private:
+  struct Segment {
+    double t0;              // start time
+    double p0, v0, a0;      // state at t0 (unsigned direction)
+    double jerk;
+  };
+
+  void build(double dist, const ProfileConstraints& limits);
+
+  std::array<Segment, 7> segs{};
+  int count{0};
+  double total{0.0};
+  double sign{1.0};
+};
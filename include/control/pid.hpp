@@ -1,21 +1,66 @@
 #pragma once
 #include <algorithm>
+#include "telemetry/telemetry.hpp"
 
+// PID with the usual production fixes:
+//  - D acts on the measurement, so target steps don't kick the output
+//  - optional first-order low-pass on D (IMU/encoder noise)
+//  - back-calculation anti-windup against outLimit, plus an error band
+//    outside which the integral is frozen
+//  - gains interpolated by |error| from a small schedule
+//
+// The integral is kept as an output-space term, so gain changes from the
+// schedule don't bump the output.
 class PID {
 public:
+  struct Gains {
+    double kP, kI, kD;
+  };
+
+  // Gains in effect at |error| == errorAbs. Linear in between, held past the ends.
+  struct GainPoint {
+    double errorAbs;
+    Gains gains;
+  };
+
+  static constexpr int MAX_SCHEDULE = 8;
+
   PID(double kP, double kI, double kD);
 
   void reset();
   double step(double target, double current, double dt);
 
   void setOutputLimit(double maxAbs);
-  void setIntegralLimit(double maxAbs);
+  void setIntegralLimit(double maxAbs);       // clamp on the I term (output units)
+  void setIntegralBand(double maxAbsError);   // integrate only while |error| < band
+  void setDerivativeFilter(double tauSec);    // D low-pass time constant, 0 = off
+
+  // Back-calculation gain (1/s) bleeding I by (saturated - raw) output.
+  // Default (< 0) tracks at kI/kP, i.e. the integral time constant.
+  void setAntiWindup(double gainPerSec);
+
+  // Points sorted by errorAbs ascending; replaces the fixed gains.
+  // count <= 0 goes back to the constructor gains.
+  void setGainSchedule(const GainPoint* points, int count);
+
+  // Logs target, current, output, P, I, D every step (nullptr = off)
+  void setLog(telemetry::Channel* channel);
 
 private:
-  double kP, kI, kD;
-  double integral{0.0};
-  double lastError{0.0};
+  Gains gainsAt(double errorAbs) const;
+
+  Gains base;
+  GainPoint schedule[MAX_SCHEDULE];
+  int scheduleLen{0};
+
+  double iTerm{0.0};
+  double lastCurrent{0.0};
+  double dFiltered{0.0};
   double outLimit{12000.0};
   double iLimit{1e9};
+  double iBand{1e9};
+  double dTau{0.0};
+  double awGain{-1.0};
   bool firstStep{true};
+  telemetry::Channel* log{nullptr};
 };
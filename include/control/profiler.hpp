@@ -0,0 +1,57 @@
+#pragma once
+#include <cstdint>
+
+// Execution-time profiling for control code.
+//
+// Each named section keeps a fixed 100us-bin histogram (0..10ms + overflow),
+// so min/mean/p99/max and budget overruns cost no allocation and a couple of
+// relaxed atomics per sample. Every FixedRate loop is profiled automatically
+// (busy time per tick against its period); other code can use ProfileScope:
+//
+//   static profiler::Section odomStep("odom.step", 2000);
+//   { ProfileScope scope(odomStep); ... }
+namespace profiler {
+  constexpr int MAX_SECTIONS = 24;
+  constexpr int BIN_US = 100;
+  constexpr int BINS = 100;  // + 1 overflow bin
+
+  // Handle to a stats slot; same name -> same slot
+  class Section {
+  public:
+    explicit Section(const char* name, std::uint32_t budgetUs = 0);
+    void record(std::uint32_t us) const;
+
+  private:
+    int slot;
+  };
+
+  struct Summary {
+    const char* name;
+    std::uint32_t count;
+    std::uint32_t overruns;  // samples over budget (0 budget = never)
+    std::uint32_t budgetUs;
+    double minUs;
+    double meanUs;
+    double p99Us;            // upper edge of the p99 bin
+    double maxUs;
+  };
+
+  bool summary(int i, Summary& out);  // false if slot i is unused
+  void reset();
+
+  // Table of every section to stdout (the serial terminal on the brain)
+  void dump();
+}
+
+class ProfileScope {
+public:
+  explicit ProfileScope(const profiler::Section& section);
+  ~ProfileScope();
+
+  ProfileScope(const ProfileScope&) = delete;
+  ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+  const profiler::Section& section;
+  std::uint64_t startUs;
+};
@@ -1,5 +1,6 @@
 #pragma once
 #include <cmath>
+#include "telemetry/telemetry.hpp"
 
 class Slew {
 public:
@@ -12,7 +13,11 @@ public:
   // returns limited value
   double step(double target, double dt);
 
+  // Logs target and limited output every step (nullptr = off)
+  void setLog(telemetry::Channel* channel);
+
 private:
   double rate;   // units per second
   double value;  // current output
+  telemetry::Channel* log{nullptr};
 };
@@ -0,0 +1,60 @@
+#pragma once
+#include "drive/drive.hpp"
+#include <cstdint>
+
+// Step-response autotuning for turnTo and driveDistance.
+//
+// Each test applies a voltage step (turn in place, then straight), fits a
+// first-order-plus-dead-time model of the rate response, and places the
+// closed-loop poles for a target settle time. The robot drives itself back
+// to where it started. Needs ~2 ft of clear space ahead.
+namespace autotune {
+  // rate(s) / mV = gain * e^(-dead*s) / (tau*s + 1)
+  struct Model {
+    double gain;     // deg/s or in/s per mV at steady state
+    double tauSec;
+    double deadSec;
+  };
+
+  // Motion::driveToPose / driveToPoint controllers. Same plants as turnTo and
+  // driveDistance, but PD only and per radian on the angular side. Starter
+  // values until a tune or tune.txt replaces them.
+  struct PoseGains {
+    PID::Gains linear{500.0, 0.0, 40.0};     // mV per inch, mV per in/s
+    PID::Gains angular{5000.0, 0.0, 300.0};  // mV per rad, mV per rad/s
+  };
+
+  struct Settings {
+    double stepMv = 6000;
+    std::uint32_t stepMs = 700;
+    double turnSettleSec = 0.6;   // small-turn settle target
+    double driveSettleSec = 1.2;  // profile tracking error settle target
+    // Pose moves steer and drive at once with no profile, so slower targets;
+    // on the sim drivetrain these reproduce the starter PoseGains
+    double poseLinearSettleSec = 1.6;
+    double poseAngularSettleSec = 1.2;
+  };
+
+  struct Result {
+    bool ok;
+    Model turnModel;
+    Model driveModel;
+    PID::Gains turn;
+    PID::Gains distance;
+    PoseGains pose;
+  };
+
+  // Heading (deg) or distance (in) controller for the model, critically
+  // damped with the given 2% settle time. Integral only if asked.
+  PID::Gains design(const Model& model, double settleSec, bool withIntegral);
+
+  // Runs both tests and applies the gains to drive on success. The pose
+  // gains are only returned; Motion sits above drive, so the caller applies
+  // them with Motion::setPoseGains.
+  Result run(Drive& drive, const Settings& settings = Settings{});
+
+  // Plain-text gains file so a retune survives a power cycle. load() leaves
+  // anything the file doesn't mention (e.g. pose lines in an older file) as is.
+  bool save(const Drive& drive, const PoseGains& pose, const char* path = "/usd/tune.txt");
+  bool load(Drive& drive, PoseGains& pose, const char* path = "/usd/tune.txt");
+}
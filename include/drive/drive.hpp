@@ -1,8 +1,9 @@
 #pragma once
-#include "pros/motors.hpp"
-#include "pros/imu.hpp"
-#include <array>
+#include "hal/drive_io.hpp"
 #include "control/pid.hpp"
+#include "control/feedforward.hpp"
+#include "control/motion_profile.hpp"
+#include <atomic>
 #include <cmath>
 #include "control/slew.hpp"
 
@@ -10,31 +11,68 @@
 
 class Drive {
 public:
-  Drive(int l1, int l2, int l3, int r1, int r2, int r3, int imuPort);
+  // Hardware comes from hal (V5DriveIO on the brain, SimDriveIO natively)
+  explicit Drive(hal::DriveIO& io);
 
   // Call once in initialize()
   void calibrateImu();
 
-  // PID turn (degrees). Blocking call.
+  // Profiled turn (degrees): angular feedforward plus PID trim. Blocking call.
   void turnTo(double targetHeadingDeg);
 
   // Driver control helpers
   void tank(int leftPct, int rightPct);      // -100..100
+  // Nominal millivolts (constants::NOMINAL_BATTERY_MV): rescaled by the
+  // filtered battery voltage so a command gives the same torque on a fresh
+  // or a sagging battery, short of the motors' own 12000 mV ceiling (past
+  // it both sides scale down together, keeping the curvature)
   void setVoltage(int leftMv, int rightMv);  // -12000..12000
+  // Last setVoltage() request, clamped but before slew (what a recording replays)
+  int commandedLeftMv() const { return commandLeft; }
+  int commandedRightMv() const { return commandRight; }
   void brakeHold(bool enabled);
 
+  // Scales everything setVoltage() sends, after slew and before battery
+  // compensation (Thermal's power budget)
+  void setOutputScale(double s) { scale.store(s, std::memory_order_relaxed); }
+  double outputScale() const { return scale.load(std::memory_order_relaxed); }
+
   // Drive forward/backward a distance (inches), while holding a heading (deg).
-  // If headingHoldDeg is NAN, it holds the current heading at start.
+  // Follows a motion profile (default limits from constants) with feedforward
+  // plus position/velocity trim. If headingHoldDeg is NAN, it holds the
+  // current heading at start.
   void driveDistance(double inches, double headingHoldDeg = NAN);
+  void driveDistance(double inches, const ProfileConstraints& limits, double headingHoldDeg = NAN);
+
+  // Feedforward used by profiled moves (sysid fits both)
+  void setFeedforward(const Feedforward& model);
+  Feedforward feedforward() const { return ff; }
+
+  // Turning in place, per side: mV, mV per deg/s, mV per deg/s^2
+  void setAngularFeedforward(const Feedforward& model);
+  Feedforward angularFeedforward() const { return angularFf; }
+
+  // Closed-loop gains (hand-tuned defaults, autotune overrides).
+  // Turn: gains near the target; the far-out schedule scales from them.
+  // Distance: kP mV/in and kI on profile position error, kD mV per in/s
+  // on profile velocity error.
+  void setTurnGains(const PID::Gains& near);
+  void setDistanceGains(const PID::Gains& gains);
+  PID::Gains turnGains() const { return turnNear; }
+  PID::Gains distanceGains() const { return distance; }
 
   // Arcade drive helper
   void arcade(int forwardPct, int turnPct); // -100..100
 
   // Sensors
   void tareEncoders();
+  hal::DriveSample sample() const; // both sides, one read each, device-timestamped
   double leftMotorDeg() const;   // avg of left motors
   double rightMotorDeg() const;  // avg of right motors
   double headingDeg() const;     // 0..360 from IMU
+  double yawRateDps() const;     // IMU gyro, clockwise positive
+  double forwardAccelG() const;  // IMU accel along forward
+  hal::DrivePower power() const { return io.power(); }  // slow; Thermal polls it
 
   // Slew rate control
   void enableSlew(bool enabled);
@@ -46,11 +84,17 @@ public:
   
 
 private:
-  std::array<pros::Motor, 3> left;
-  std::array<pros::Motor, 3> right;
-  pros::Imu imu;
+  hal::DriveIO& io;
   Slew leftSlew{24000.0};
   Slew rightSlew{24000.0};
   int lastMs{0};
+  int commandLeft{0};
+  int commandRight{0};
+  std::atomic<double> scale{1.0};
+  double batteryFilteredMv{0.0};   // 0 until the first reading
   bool slewEnabled{true};
+  Feedforward ff;
+  Feedforward angularFf;
+  PID::Gains turnNear{400.0, 800.0, 35.0};
+  PID::Gains distance{300.0, 0.0, 15.0};
 };
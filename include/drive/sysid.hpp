@@ -0,0 +1,36 @@
+#pragma once
+#include "drive/drive.hpp"
+#include <cstdint>
+
+// Drivetrain characterization: fits V = kS*sign(v) + kV*v + kA*a.
+//
+// Runs a quasi-static voltage ramp (kS, kV) and a dynamic step (kA) forward
+// and back, first straight and then turning in place. Both sides' samples go
+// into one least-squares fit per mode, accumulated as 3x3 normal equations
+// so nothing is buffered. Straight tests need ~3 ft of clear space ahead.
+namespace sysid {
+  struct Settings {
+    double rampMvPerSec = 1500;
+    double rampMaxMv = 4500;
+    double stepMv = 7000;
+    std::uint32_t stepMs = 600;
+  };
+
+  struct Fit {
+    Feedforward model;
+    double r2;       // coefficient of determination
+    int samples;
+  };
+
+  struct Result {
+    bool ok;
+    Fit linear;      // mV, mV per in/s, mV per in/s^2
+    Fit angular;     // mV, mV per deg/s, mV per deg/s^2 (per side, turning in place)
+  };
+
+  // Runs every test and applies both models to drive on success
+  Result run(Drive& drive, const Settings& settings = Settings{});
+
+  bool save(const Drive& drive, const char* path = "/usd/sysid.txt");
+  bool load(Drive& drive, const char* path = "/usd/sysid.txt");
+}
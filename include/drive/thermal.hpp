@@ -0,0 +1,71 @@
+#pragma once
+#include "drive/drive.hpp"
+#include "util/seqlock.hpp"
+#include <atomic>
+#include <cstdint>
+
+// Drive motor thermal model. Blue motors halve their current limit at 55 C,
+// and the brain only reports temperature in 5 C steps, too coarse to see
+// that coming. Each side's hottest motor is modelled as one lump heated by
+// the measured current:
+//
+//   C dT/dt = k I^2 R - (T - ambient) / Rth
+//
+// kept inside the sensor's 5 C band. When the reading steps up the model
+// snaps to it, and between two consecutive steps up k is fitted to the
+// known 5 C rise. The recent average heating (a ~10 s window of
+// current history) gives each side a predicted time to the limit.
+//
+// With a deadline set (end of the match or skills run), the drive output is
+// scaled down just enough for the model to reach the limit no sooner than
+// the deadline: a gentle cap now instead of a throttle cliff later. Without
+// one, or once it's passed, it only predicts (for a controller warning).
+class Thermal {
+public:
+  struct Side {
+    double tempC;            // model
+    double sensorC;          // hottest motor as reported
+    double currentA;         // per motor, mean over the side
+    double timeToLimitS;     // at the recent average heating; INFINITY if never
+  };
+
+  struct Status {
+    Side left;
+    Side right;
+    double budget;           // drive output scale, 1 = full power
+    bool overTemp;           // firmware already limiting a motor
+  };
+
+  explicit Thermal(Drive& drive);
+
+  void start();   // starts background task (once)
+
+  // hal::millis() until which the drive should stay unthrottled; 0 = none
+  void setDeadline(std::uint32_t atMs);
+
+  Status status() const;
+  double timeToLimitS() const;   // hotter side
+
+private:
+  struct Model {
+    double tempC;
+    double heatGain{1.0};     // k, learned from the sensor's steps
+    double avgWatts{0.0};     // k I^2 R, low-passed
+    double lastSensorC{-1.0};
+    bool sinceEdge{false};    // last reading change was one step up
+    double heatJ{0.0};        // unit-gain heat and cooling since then
+    double coolJ{0.0};
+  };
+
+  void loop();
+  void update(Model& m, Side& out, double sensorC, double currentA, double dt);
+  double allowedScale(const Model& m, double horizonS) const;
+
+  Drive& drive;
+  Model leftModel;
+  Model rightModel;
+  double budget{1.0};
+  std::atomic<bool> running{false};
+  std::atomic<std::uint32_t> deadlineMs{0};
+  SeqLock<Status> published;
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+namespace hal {
+  // A fixed set of distance sensors; mounts are in config/constants.hpp
+  class DistanceIO {
+  public:
+    // V5 distance sensor range; past it the sensor sees nothing
+    static constexpr double MAX_RANGE_IN = 2000.0 / 25.4;
+
+    enum class Reading {
+      INVALID,     // unplugged, error, or too low confidence to use
+      HIT,         // out holds inches to the nearest surface
+      NO_RETURN,   // nothing within MAX_RANGE_IN: no wall that close either
+    };
+
+    virtual ~DistanceIO() = default;
+
+    virtual int count() const = 0;
+
+    virtual Reading readIn(int i, double& out) = 0;
+  };
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+
+namespace hal {
+  // One encoder read per side, stamped with the device's own sample time
+  struct DriveSample {
+    double leftDeg;             // avg motor degrees, left side
+    double rightDeg;            // avg motor degrees, right side
+    std::uint32_t leftTimeMs;   // hal::millis() timebase
+    std::uint32_t rightTimeMs;
+  };
+
+  // Motor health per side, for the thermal model. V5 motors report
+  // temperature in 5 C steps.
+  struct DrivePower {
+    double leftTempC;           // hottest motor on the side
+    double rightTempC;
+    double leftCurrentA;        // per motor, mean over the side
+    double rightCurrentA;
+    bool overTemp;              // firmware is already limiting a motor
+  };
+
+  // Drivetrain hardware seen by Drive: two motor sides + heading sensor.
+  // Implemented by V5DriveIO on the brain and sim::SimDriveIO on a workstation.
+  class DriveIO {
+  public:
+    virtual ~DriveIO() = default;
+
+    virtual void setVoltage(int leftMv, int rightMv) = 0;  // already clamped
+    virtual void setBrakeHold(bool enabled) = 0;
+    virtual void tare() = 0;
+
+    virtual DriveSample sample() const = 0;
+    virtual double headingDeg() const = 0;  // 0..360, clockwise positive
+    virtual double yawRateDps() const = 0;  // gyro, clockwise positive
+    virtual double forwardAccelG() const = 0;  // IMU accel along the robot's forward axis
+
+    virtual void calibrateImu() = 0;        // blocking
+
+    virtual DrivePower power() const = 0;   // several device reads; not for fast loops
+    virtual double batteryMv() const = 0;   // cheap; Drive reads it every command
+  };
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include <cstdint>
+
+namespace hal {
+  // Absolute pose fix, already in Odom's field frame and conventions
+  // (inches, theta clockwise positive, x along theta = 0).
+  struct GpsSample {
+    double xIn;
+    double yIn;
+    double headingDeg;
+    double errorIn;             // sensor's own RMS error estimate
+    std::uint32_t timeMs;       // when the fix was valid, hal::millis() timebase
+  };
+
+  class GpsIO {
+  public:
+    virtual ~GpsIO() = default;
+
+    // False if the sensor has no usable fix right now
+    virtual bool read(GpsSample& out) const = 0;
+  };
+}
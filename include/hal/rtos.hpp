@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+
+// Thin RTOS layer so control code runs on the brain and in the native sim.
+// The V5 build links src/hal/rtos_v5.cpp, the sim links sim/sim_runtime.cpp.
+namespace hal {
+  // Same scale as PROS (TASK_PRIORITY_MIN 1 .. MAX 16)
+  constexpr std::uint32_t PRIORITY_LOW = 2;
+  constexpr std::uint32_t PRIORITY_DEFAULT = 8;
+
+  std::uint32_t millis();
+  std::uint64_t micros();
+  void delay(std::uint32_t ms);
+
+  // Task::delay_until: sleeps until *prevMs + periodMs and advances *prevMs.
+  // Returns immediately if that time has already passed.
+  void delayUntil(std::uint32_t* prevMs, std::uint32_t periodMs);
+
+  // Starts fn on its own task (never returns a handle, same as our pros::Task use)
+  void startTask(std::function<void()> fn, const char* name, std::uint32_t priority = PRIORITY_DEFAULT);
+
+  // Identifies the calling task; only good for comparing, never 0
+  std::uintptr_t currentTask();
+}
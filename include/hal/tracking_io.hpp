@@ -0,0 +1,19 @@
+#pragma once
+
+namespace hal {
+  // Unpowered tracking wheels: two parallel to the drive, one perpendicular.
+  // Readings are sensor degrees, positive = robot forward / robot right.
+  struct TrackingSample {
+    double leftDeg;
+    double rightDeg;
+    double backDeg;
+  };
+
+  class TrackingIO {
+  public:
+    virtual ~TrackingIO() = default;
+
+    // False if any sensor didn't answer; out then holds the last good readings
+    virtual bool read(TrackingSample& out) const = 0;
+  };
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include "hal/distance_io.hpp"
+#include "pros/distance.hpp"
+
+namespace hal {
+  // Up to four V5 distance sensors (port 0 = not fitted)
+  class V5DistanceIO : public DistanceIO {
+  public:
+    static constexpr int MAX = 4;
+
+    V5DistanceIO(int p0, int p1, int p2, int p3);
+
+    int count() const override { return n; }
+    Reading readIn(int i, double& out) override;
+
+  private:
+    pros::Distance sensors[MAX];
+    int n;
+  };
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "hal/drive_io.hpp"
+#include "pros/motor_group.hpp"
+#include "pros/imu.hpp"
+
+namespace hal {
+  // Real hardware: 3-motor group per side + IMU
+  class V5DriveIO : public DriveIO {
+  public:
+    V5DriveIO(int l1, int l2, int l3, int r1, int r2, int r3, int imuPort);
+
+    void setVoltage(int leftMv, int rightMv) override;
+    void setBrakeHold(bool enabled) override;
+    void tare() override;
+
+    DriveSample sample() const override;
+    double headingDeg() const override;
+    double yawRateDps() const override;
+    double forwardAccelG() const override;
+
+    void calibrateImu() override;
+
+    DrivePower power() const override;
+    double batteryMv() const override;
+
+  private:
+    pros::MotorGroup left;
+    pros::MotorGroup right;
+    pros::Imu imu;
+
+    // Raw counts ignore tare_position, so tare() keeps its own zero
+    double leftZeroCounts{0.0};
+    double rightZeroCounts{0.0};
+  };
+}
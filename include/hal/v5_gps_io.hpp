@@ -0,0 +1,17 @@
+#pragma once
+#include "hal/gps_io.hpp"
+#include "pros/gps.hpp"
+
+namespace hal {
+  // V5 GPS sensor. Its offset from the tracking center is set on the device,
+  // so readings are for the robot center.
+  class V5GpsIO : public GpsIO {
+  public:
+    V5GpsIO(int port, double xOffsetIn, double yOffsetIn);
+
+    bool read(GpsSample& out) const override;
+
+  private:
+    pros::Gps gps;
+  };
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include "hal/tracking_io.hpp"
+#include "pros/rotation.hpp"
+
+namespace hal {
+  // Three V5 rotation sensors (negative port = reversed)
+  class V5TrackingIO : public TrackingIO {
+  public:
+    V5TrackingIO(int leftPort, int rightPort, int backPort);
+
+    bool read(TrackingSample& out) const override;
+
+  private:
+    pros::Rotation left;
+    pros::Rotation right;
+    pros::Rotation back;
+    mutable TrackingSample last{0.0, 0.0, 0.0};
+  };
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include "localization/pose.hpp"
+#include "util/matrix.hpp"
+
+// Extended Kalman filter over [x, y, theta, v, omega] (in, rad, in/s, rad/s).
+//
+// predict() runs a unicycle model with IMU forward acceleration as input.
+// Measurements are scalar and applied one at a time, so an update is a
+// rank-1 correction with no matrix inverse. Each update can be gated on its
+// normalized innovation, which is how slipping encoders get ignored.
+class Ekf {
+public:
+  enum State { X, Y, THETA, V, OMEGA, N };
+  using Cov = Mat<N, N>;
+
+  // Process noise densities
+  struct Noise {
+    double accelInPerS2 = 60.0;    // unmodeled linear accel (IMU accel error)
+    double alphaRadPerS2 = 8.0;    // unmodeled angular accel
+    double posIn = 0.02;           // per sqrt(s), keeps P from collapsing
+  };
+
+  Ekf() : Ekf(Noise{}) {}
+  explicit Ekf(const Noise& noise);
+
+  void reset(const Pose& p, double v = 0.0);
+  void predict(double dt, double accelForward);
+
+  // Measures state i directly. Rejected (returns false) if the innovation is
+  // beyond gateSigma standard deviations; gateSigma <= 0 never gates.
+  // THETA innovations are wrapped to [-pi, pi].
+  bool update(State i, double z, double variance, double gateSigma = 0.0);
+
+  // Moves the estimate without touching covariance (external corrections)
+  void shift(double dx, double dy, double dTheta);
+
+  Pose pose() const { return Pose{s[X], s[Y], s[THETA]}; }
+  double velocity() const { return s[V]; }
+  double yawRate() const { return s[OMEGA]; }
+  const Cov& covariance() const { return P; }
+
+private:
+  Noise noise;
+  double s[N]{};
+  Cov P;
+};
@@ -0,0 +1,31 @@
+#pragma once
+#include <cmath>
+
+// Field wall model for distance-sensor localization, in Odom's field frame
+// (inches, origin at field center, theta clockwise positive from +x).
+//
+// Only the perimeter: on-field elements move or get pushed, walls don't.
+// Being axis-aligned is what lets Mcl raycast four particles per NEON op.
+namespace field {
+  constexpr double TILE_IN = 23.4;
+  constexpr int TILES = 6;
+  constexpr double HALF_IN = TILE_IN * TILES / 2.0;  // center -> inside face of a wall
+
+  static_assert(TILES > 0 && TILES % 2 == 0, "field must be an even number of tiles across");
+  static_assert(HALF_IN > 60.0 && HALF_IN < 80.0, "field half-width outside a 12 ft field");
+
+  constexpr bool inside(double x, double y, double marginIn = 0.0) {
+    return x > -HALF_IN + marginIn && x < HALF_IN - marginIn &&
+           y > -HALF_IN + marginIn && y < HALF_IN - marginIn;
+  }
+
+  // Distance from (x, y) along heading dir to the first wall. Scalar
+  // reference for the vectorized version in Mcl and for the sim sensors.
+  inline double raycast(double x, double y, double dirRad) {
+    const double c = std::cos(dirRad);
+    const double s = std::sin(dirRad);
+    const double tx = std::abs(c) > 1e-9 ? ((c > 0 ? HALF_IN : -HALF_IN) - x) / c : 1e9;
+    const double ty = std::abs(s) > 1e-9 ? ((s > 0 ? HALF_IN : -HALF_IN) - y) / s : 1e9;
+    return tx < ty ? tx : ty;
+  }
+}
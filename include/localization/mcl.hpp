@@ -0,0 +1,98 @@
+#pragma once
+#include "localization/pose.hpp"
+#include "localization/odom.hpp"
+#include "hal/distance_io.hpp"
+#include "hal/gps_io.hpp"
+#include "util/seqlock.hpp"
+#include <atomic>
+#include <cstdint>
+
+// Monte Carlo localization: particles moved by odometry, weighted by how
+// well the distance sensors agree with the field walls from each one.
+//
+// Mcl is a GpsIO, so Odom fuses its estimate exactly like a GPS fix (same
+// latency rewind, gating and blending), with the particle spread as the
+// sensor error. It consumes Odom's dead-reckoned pose, never the corrected
+// one, so its own corrections don't feed back into it.
+//
+// Particles are stored as separate float arrays (x[], y[], theta[]) so the
+// per-sensor raycast and likelihood run four particles per NEON op.
+class Mcl : public hal::GpsIO {
+public:
+  static constexpr int PARTICLES = 512;
+
+  Mcl(Odom& odom, hal::DistanceIO& sensors);
+
+  void start();   // starts background task
+
+  // Start tracking near a known pose (auton start, after a reset)
+  void initAround(const Pose& p, double sigmaIn = 2.0, double sigmaRad = 0.02);
+
+  // Position unknown, heading known (IMU): spread over the whole field
+  void initGlobal(double thetaRad, double sigmaRad = 0.02);
+
+  struct Estimate {
+    Pose pose;                // weighted mean around the best particle
+    double spreadIn;          // weighted RMS distance of that neighbourhood from pose
+    std::uint32_t timeMs;     // odom time the particles were valid at
+    bool valid;               // false until the first sensor update, and while multimodal
+  };
+  Estimate estimate() const;
+
+  // Fix for Odom; false until an estimate exists
+  bool read(hal::GpsSample& out) const override;
+
+  struct Stats {
+    std::uint32_t updates;    // ticks with at least one usable reading
+    std::uint32_t resamples;
+  };
+  Stats stats() const;
+
+private:
+  struct InitRequest {
+    Pose center;
+    double sigmaIn;
+    double sigmaRad;
+    bool global;
+  };
+
+  void loop();
+  void applyInit(const InitRequest& req);
+  void predict(const Pose& delta);
+  int weigh();                            // returns usable readings
+  void weighSensor(float mx, float my, float ca, float sa, float z, bool atLeast);
+  void resample(float inject);
+  void publish(std::uint32_t timeMs);
+  float gaussian(float sigma);
+  float uniform();
+
+  Odom& odom;
+  hal::DistanceIO& sensors;
+  int sensorCount;
+
+  // Double-buffered so resampling copies from one set into the other
+  alignas(16) float xs[2][PARTICLES];
+  alignas(16) float ys[2][PARTICLES];
+  alignas(16) float thetas[2][PARTICLES];
+  alignas(16) float cosT[PARTICLES];      // of the current thetas, shared by every sensor
+  alignas(16) float sinT[PARTICLES];
+  alignas(16) float logW[PARTICLES];
+  int cur{0};
+
+  // Augmented MCL state, see mcl.cpp
+  float prevSum{PARTICLES};   // linear weight total left by the last publish
+  float wSlow{0.0f};
+  float wFast{0.0f};
+
+  Pose lastOdom{0, 0, 0};
+  std::uint32_t rng{0x9e3779b9u};
+
+  // initAround/initGlobal hand their request to the task, like Odom::reset
+  std::atomic<bool> running{false};
+  std::atomic<bool> initPending{false};
+  SeqLock<InitRequest> initRequest;
+
+  SeqLock<Estimate> est{Estimate{Pose{0, 0, 0}, 0.0, 0, false}};
+  std::atomic<std::uint32_t> updates{0};
+  std::atomic<std::uint32_t> resamples{0};
+};
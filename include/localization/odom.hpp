@@ -1,24 +1,119 @@
 #pragma once
 #include "localization/pose.hpp"
+#include "localization/ekf.hpp"
 #include "drive/drive.hpp"
+#include "hal/tracking_io.hpp"
+#include "hal/gps_io.hpp"
+#include "util/seqlock.hpp"
 #include <atomic>
 
 class Odom {
 public:
-  explicit Odom(Drive& drive);
+  // With tracking wheels, pose comes from them alone (arc update). If a
+  // sensor stops answering, odom falls back to the motor-encoder mode below
+  // until the next reset().
+  // Without, an EKF fuses drive motor encoders with IMU heading, gyro rate
+  // and acceleration; encoder velocity that disagrees with the IMU (slip,
+  // pushing matches) is gated out.
+  //
+  // A GPS, if given, corrects either mode: each fix is compared against the
+  // pose from when it was taken, and the correction is blended in over a
+  // few ticks so the pose never jumps. Fixes that keep failing the gate for
+  // a second mean odom itself is lost, and it jumps onto the next one.
+  explicit Odom(Drive& drive, hal::TrackingIO* tracking = nullptr, hal::GpsIO* gps = nullptr);
 
   void start();           // starts background task
-  void reset(Pose p);     // set pose + tare baselines
-  Pose get() const;       // current pose snapshot
+  void reset(Pose p);     // set pose + tare baselines (applied by the odom task once running)
+  Pose get() const;       // current pose snapshot, never torn
+  PoseStamped getStamped() const;
+
+  // Odometry alone, never moved by GPS/Mcl corrections. Only differences
+  // between two readings mean anything once a correction source is fused.
+  PoseStamped getDeadReckoned() const;
+
+  // EKF covariance over [x, y, theta, v, omega] (motor-encoder mode only;
+  // zero with tracking wheels)
+  Ekf::Cov covariance() const;
+
+  // Motor-encoder mode flags slip when encoder acceleration or yaw rate
+  // disagrees with the IMU; while slipping the EKF runs on the IMU and
+  // encoder velocity is heavily down-weighted. Counts since power-on.
+  struct SlipStats {
+    std::uint32_t events;
+    std::uint32_t slipMs;     // total time flagged
+  };
+  SlipStats slipStats() const;
+
+  struct GpsStats {
+    std::uint32_t accepted;
+    std::uint32_t rejected;   // poor sensor error, too old, or failed the gate
+  };
+  GpsStats gpsStats() const;
+
+  // Tracking wheels were given but a sensor dropped out (motor mode now)
+  bool trackingLost() const;
 
 private:
   void loop();            // task loop
+  void applyReset(const Pose& p);
+  void captureBaselines();
+  bool usingTracking() const;
+  void fallBackToMotors(const Pose& p);
+  PoseStamped stepMotors(const PoseStamped& prev);
+  bool detectSlip(double encVel, double encOmega, double imuAccel, double gyroOmega, double dt);
+  PoseStamped stepTracking(const PoseStamped& prev);
+  PoseStamped correctGps(const PoseStamped& prev, PoseStamped next);
+  bool fuseGps(const hal::GpsSample& fix, const Pose& current);
+  bool poseAt(std::uint64_t timeUs, Pose& out) const;
 
   Drive& drive;
-  std::atomic<double> x{0.0};
-  std::atomic<double> y{0.0};
-  std::atomic<double> theta{0.0}; // radians
+  hal::TrackingIO* tracking;
+  hal::GpsIO* gps;
+  // Written only by the odom task (or reset() before start()), read lock-free
+  SeqLock<PoseStamped> pose{PoseStamped{Pose{0, 0, 0}, 0}};
+  SeqLock<PoseStamped> deadReckoned{PoseStamped{Pose{0, 0, 0}, 0}};
+  Pose deadReckonedPose{0, 0, 0};
+
+  // reset() hands its pose to the odom task so there's only ever one writer
+  std::atomic<bool> running{false};
+  std::atomic<bool> resetPending{false};
+  SeqLock<Pose> resetPose;
 
   double lastLeftDeg{0.0};
   double lastRightDeg{0.0};
+  std::uint32_t lastLeftTimeMs{0};
+  std::uint32_t lastRightTimeMs{0};
+  double headingOffsetRad{0.0};   // pose theta - IMU heading
+
+  Ekf ekf;
+  SeqLock<Ekf::Cov> cov;
+  int velRejects{0};              // consecutive gated-out encoder velocities
+
+  double lastEncVel{0.0};
+  double velResid{0.0};           // leaky integral of encoder - IMU accel, in/s
+  double omegaResid{0.0};         // rad/s
+  int slipTicks{0};               // toward entering/leaving slip
+  bool slipping{false};
+  std::atomic<std::uint32_t> slipEvents{0};
+  std::atomic<std::uint32_t> slipMs{0};
+
+  double lastTrackLeftDeg{0.0};
+  double lastTrackRightDeg{0.0};
+  double lastTrackBackDeg{0.0};
+  double trackVelIn{0.0};         // forward, last tracking step; seeds the EKF on fallback
+  std::atomic<bool> lostTracking{false};
+
+  // GPS: recent poses to rewind to, and the correction still to blend in
+  static constexpr int HISTORY = 32;  // 320ms
+  PoseStamped history[HISTORY]{};
+  int historyHead{0};
+  int historyCount{0};
+  Pose pending{0, 0, 0};
+  double driftVarIn2{0.0};        // odom position variance accumulated since the last fix
+  double driftVarRad2{0.0};
+  int gateRejects{0};
+  bool relocalize{false};         // apply the pending correction in one step
+  std::uint32_t lastGpsMs{0};
+  std::atomic<std::uint32_t> gpsAccepted{0};
+  std::atomic<std::uint32_t> gpsRejected{0};
 };
@@ -1,7 +1,57 @@
 #pragma once
+#include <cmath>
+#include <cstdint>
 
 struct Pose {
   double x;       // inches
   double y;       // inches
-  double theta;   // radians (CCW, 0 = +x)
+  double theta;   // radians, clockwise positive (0 = +x, +90 deg = +y)
 };
+
+// Pose plus the time its sensor data was sampled
+struct PoseStamped {
+  Pose pose;
+  std::uint64_t timeUs;  // hal::micros() timebase
+};
+
+// Exact constant-curvature (pose exponential) update.
+// dForward/dLateral are robot-frame displacements over the step, dTheta the
+// heading change. Lateral is positive toward increasing theta. Reduces to a
+// straight step as dTheta -> 0.
+inline Pose integrateTwist(const Pose& p, double dForward, double dLateral, double dTheta) {
+  double s, c;
+  if (std::abs(dTheta) < 1e-9) {
+    s = 1.0 - dTheta * dTheta / 6.0;   // sin(t)/t
+    c = dTheta / 2.0;                  // (1 - cos(t))/t
+  } else {
+    s = std::sin(dTheta) / dTheta;
+    c = (1.0 - std::cos(dTheta)) / dTheta;
+  }
+
+  const double localX = s * dForward - c * dLateral;
+  const double localY = c * dForward + s * dLateral;
+
+  const double cosT = std::cos(p.theta);
+  const double sinT = std::sin(p.theta);
+  return Pose{ p.x + localX * cosT - localY * sinT,
+               p.y + localX * sinT + localY * cosT,
+               p.theta + dTheta };
+}
+
+// Motion from `from` to `to` expressed in from's frame (x forward, y toward
+// +theta), and its inverse. compose(a, relativeTo(a, b)) == b.
+inline Pose relativeTo(const Pose& from, const Pose& to) {
+  const double dx = to.x - from.x;
+  const double dy = to.y - from.y;
+  const double c = std::cos(from.theta);
+  const double s = std::sin(from.theta);
+  return Pose{dx * c + dy * s, -dx * s + dy * c, to.theta - from.theta};
+}
+
+inline Pose compose(const Pose& base, const Pose& delta) {
+  const double c = std::cos(base.theta);
+  const double s = std::sin(base.theta);
+  return Pose{base.x + delta.x * c - delta.y * s,
+              base.y + delta.x * s + delta.y * c,
+              base.theta + delta.theta};
+}
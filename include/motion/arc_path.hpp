@@ -0,0 +1,53 @@
+#pragma once
+#include "localization/pose.hpp"
+#include "motion/waypoint.hpp"
+#include <vector>
+
+// Runtime path parameterized by arc length s (inches from the start).
+//
+// Built once from samples: cumulative length (strictly increasing, repeated
+// points dropped), heading from the local tangent and curvature from the
+// circle through each point and its neighbours. Queries interpolate between
+// the two samples around s.
+//
+// Lookups remember the last segment and gallop (1, 2, 4, ... segments) from
+// there before a binary search, so a follower that moves steadily along the
+// path pays O(1) per query, and a jump anywhere costs O(log n). That cache
+// makes queries non-const: one ArcPath per follower.
+class ArcPath {
+public:
+  ArcPath() = default;
+  explicit ArcPath(const std::vector<Waypoint>& points);
+  explicit ArcPath(const PathView& path);
+
+  // Samples curve.point(t) for t in [0, 1] (e.g. a spline:: curve)
+  template <typename Curve>
+  static ArcPath fromCurve(const Curve& curve, int samples) {
+    std::vector<Waypoint> pts;
+    pts.reserve(samples);
+    for (int i = 0; i < samples; i++) pts.push_back(curve.point((double)i / (samples - 1)));
+    return ArcPath(pts);
+  }
+
+  int size() const { return (int)pts.size(); }
+  double length() const { return s.empty() ? 0.0 : s.back(); }
+
+  // s is clamped to [0, length()]
+  Pose poseAt(double s);              // theta along the tangent
+  Waypoint tangentAt(double s);       // unit vector
+  double curvatureAt(double s);       // 1/in, + toward +theta
+
+  // Raw samples, e.g. for PurePursuit
+  const std::vector<Waypoint>& points() const { return pts; }
+  const std::vector<double>& lengths() const { return s; }
+
+private:
+  void build();
+  int segmentAt(double at, double& t);
+
+  std::vector<Waypoint> pts;
+  std::vector<double> s;
+  std::vector<double> theta;          // unwrapped, so interpolation never crosses +-pi
+  std::vector<double> curvature;
+  int cursor{0};
+};
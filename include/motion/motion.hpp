@@ -1,15 +1,65 @@
 #pragma once
 #include "drive/drive.hpp"
+#include "drive/autotune.hpp"
 #include "localization/odom.hpp"
+#include "motion/pure_pursuit.hpp"
+#include "control/command.hpp"
+#include <vector>
+
+struct PoseParams {
+  double lead = 0.4;             // carrot distance as a fraction of distance to target (0 = point turn-and-drive)
+  double maxMv = 10000.0;
+  // NAN = Motion's pose gains (autotuned or from tune.txt)
+  double kLinearP = NAN;         // mV per inch
+  double kLinearD = NAN;         // mV per inch/s
+  double kAngularP = NAN;        // mV per rad
+  double kAngularD = NAN;        // mV per rad/s
+  double finalApproachIn = 3.0;  // inside this, steer to the final heading instead of the carrot
+
+  double settleDistIn = 1.0;
+  double settleHeadingDeg = 3.0;
+  int settleMs = 100;
+  int timeoutMs = 4000;
+};
 
 class Motion {
 public:
   Motion(Drive& drive, Odom& odom);
 
-  // Blocking: drives to a point in inches
+  // Blocking: drives to a point in inches, P-only on the pose gains
   void driveToPoint(double targetX, double targetY);
 
+  // Blocking: drives to (x, y) and arrives facing thetaDeg (IMU heading degrees)
+  // by chasing a carrot point placed behind the target along its heading.
+  void driveToPose(double targetX, double targetY, double thetaDeg, const PoseParams& params = {});
+
+  // Blocking: pure pursuit through waypoints (inches) without stopping at them.
+  // The current pose is used as the start of the path.
+  void followPath(const std::vector<Waypoint>& waypoints, const PursuitParams& params = {});
+
+  // Blocking: pure pursuit along a precomputed path (spline::bake), which
+  // starts at its own first point rather than the current pose
+  void followPath(const PathView& path, const PursuitParams& params = {});
+
+  // Non-blocking versions: run on a motion task and return right away so
+  // mechanisms can run meanwhile. Starting another one, or any blocking
+  // move from another task, cancels the previous and waits for it.
+  MotionHandle turnToAsync(double targetHeadingDeg);
+  MotionHandle driveDistanceAsync(double inches, double headingHoldDeg = NAN);
+  MotionHandle driveToPointAsync(double targetX, double targetY);
+  MotionHandle driveToPoseAsync(double targetX, double targetY, double thetaDeg, const PoseParams& params = {});
+  MotionHandle followPathAsync(const std::vector<Waypoint>& waypoints, const PursuitParams& params = {});
+  MotionHandle followPathAsync(const PathView& path, const PursuitParams& params = {});
+
+  // Gains for driveToPose and driveToPoint. Set from autotune::run or
+  // autotune::load before moving; not safe to change mid-move.
+  void setPoseGains(const autotune::PoseGains& gains) { pose = gains; }
+  autotune::PoseGains poseGains() const { return pose; }
+
 private:
+  void runPursuit(PurePursuit& pursuit, const PursuitParams& params);
+
   Drive& drive;
   Odom& odom;
+  autotune::PoseGains pose;
 };
@@ -0,0 +1,61 @@
+#pragma once
+#include "localization/pose.hpp"
+#include "motion/waypoint.hpp"
+#include "motion/arc_path.hpp"
+#include <vector>
+
+struct PursuitParams {
+  // Lookahead grows with commanded speed between these
+  double minLookaheadIn = 8.0;
+  double maxLookaheadIn = 16.0;
+
+  double maxMv = 10000.0;
+  double minMv = 2500.0;            // floor so the robot doesn't stall mid-path
+  double curvatureMvIn = 1200.0;    // speed cap = curvatureMvIn / |curvature|
+  double slowdownMvPerIn = 500.0;   // speed cap = slowdownMvPerIn * remaining distance
+
+  double endToleranceIn = 1.0;
+  int timeoutMs = 8000;
+};
+
+// Pure pursuit state for one path. step() is O(1) amortized: the closest
+// point and the lookahead point only ever move forward along the path, so
+// each tick only looks at the segment(s) just ahead of last tick's result.
+class PurePursuit {
+public:
+  PurePursuit(std::vector<Waypoint> path, const PursuitParams& params);
+
+  // Follows a precomputed path in place: no copies, no setup math. Its
+  // velocity profile caps the speed on top of params.
+  PurePursuit(const PathView& path, const PursuitParams& params);
+
+  // Points into its own storage
+  PurePursuit(const PurePursuit&) = delete;
+  PurePursuit& operator=(const PurePursuit&) = delete;
+
+  // Wheel voltages for this pose. Returns false once the end is reached.
+  bool step(const Pose& pose, double& leftMv, double& rightMv);
+
+  double remainingIn() const;
+
+private:
+  void advanceClosest(double px, double py);
+  Waypoint findLookahead(double px, double py, double lookaheadIn);
+
+  double profileAt(int seg, double t) const;
+
+  // Runtime paths own their points; baked ones are only pointed at
+  ArcPath owned;
+  const Waypoint* pts;
+  const double* cumLen;         // path length at the start of each point
+  const double* profile{nullptr};
+  int count;
+  double profileMaxVel{1.0};
+  PursuitParams params;
+
+  int closestSeg{0};
+  double closestT{0.0};
+  int lookSeg{0};
+  double lookT{0.0};
+  double lastSpeedMv{0.0};
+};
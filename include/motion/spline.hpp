@@ -0,0 +1,235 @@
+#pragma once
+#include "motion/waypoint.hpp"
+#include "localization/field_map.hpp"
+
+// Compile-time path generation. Curves are sampled at equal arc length,
+// with curvature and a velocity profile, all in constexpr, so a path is a
+// constant table in flash and costs nothing to set up in auton:
+//
+//   constexpr auto PATH = spline::bake<48>(spline::CatmullRom<4>{{{0, 0}, {24, 0}, {24, 24}, {0, 24}}});
+//   static_assert(spline::insideField(PATH, 9.0), "path leaves the field");
+//   motion.followPath(PATH.view());
+//
+// Every curve is parameterized t in [0, 1] with point(t), d1(t) and d2(t).
+// Curvature is positive toward +theta, same as PurePursuit.
+namespace spline {
+  // <cmath> isn't constexpr until C++26
+  constexpr double abs(double v) { return v < 0 ? -v : v; }
+
+  constexpr double sqrt(double v) {
+    if (v <= 0) return 0.0;
+    double r = v > 1 ? v : 1.0;
+    for (int i = 0; i < 64; i++) {
+      const double next = 0.5 * (r + v / r);
+      if (abs(next - r) <= 1e-12 * r) return next;
+      r = next;
+    }
+    return r;
+  }
+
+  constexpr Waypoint operator+(Waypoint a, Waypoint b) { return Waypoint{a.x + b.x, a.y + b.y}; }
+  constexpr Waypoint operator-(Waypoint a, Waypoint b) { return Waypoint{a.x - b.x, a.y - b.y}; }
+  constexpr Waypoint operator*(double k, Waypoint a) { return Waypoint{k * a.x, k * a.y}; }
+
+  struct CubicBezier {
+    Waypoint p0, p1, p2, p3;   // p1, p2 are the handles
+
+    constexpr Waypoint point(double t) const {
+      const double u = 1 - t;
+      return (u * u * u) * p0 + (3 * u * u * t) * p1 + (3 * u * t * t) * p2 + (t * t * t) * p3;
+    }
+    constexpr Waypoint d1(double t) const {
+      const double u = 1 - t;
+      return (3 * u * u) * (p1 - p0) + (6 * u * t) * (p2 - p1) + (3 * t * t) * (p3 - p2);
+    }
+    constexpr Waypoint d2(double t) const {
+      return (6 * (1 - t)) * (p2 - 2.0 * p1 + p0) + (6 * t) * (p3 - 2.0 * p2 + p1);
+    }
+  };
+
+  // Position, velocity and acceleration pinned at both ends (in, in/t, in/t^2);
+  // curvature stays continuous across chained segments
+  struct QuinticHermite {
+    Waypoint p0, v0, a0;
+    Waypoint p1, v1, a1;
+
+    constexpr Waypoint point(double t) const {
+      const double t2 = t * t, t3 = t2 * t, t4 = t3 * t, t5 = t4 * t;
+      return (1 - 10 * t3 + 15 * t4 - 6 * t5) * p0 + (t - 6 * t3 + 8 * t4 - 3 * t5) * v0 +
+             (0.5 * t2 - 1.5 * t3 + 1.5 * t4 - 0.5 * t5) * a0 + (10 * t3 - 15 * t4 + 6 * t5) * p1 +
+             (-4 * t3 + 7 * t4 - 3 * t5) * v1 + (0.5 * t3 - t4 + 0.5 * t5) * a1;
+    }
+    constexpr Waypoint d1(double t) const {
+      const double t2 = t * t, t3 = t2 * t, t4 = t3 * t;
+      return (-30 * t2 + 60 * t3 - 30 * t4) * p0 + (1 - 18 * t2 + 32 * t3 - 15 * t4) * v0 +
+             (t - 4.5 * t2 + 6 * t3 - 2.5 * t4) * a0 + (30 * t2 - 60 * t3 + 30 * t4) * p1 +
+             (-12 * t2 + 28 * t3 - 15 * t4) * v1 + (1.5 * t2 - 4 * t3 + 2.5 * t4) * a1;
+    }
+    constexpr Waypoint d2(double t) const {
+      const double t2 = t * t, t3 = t2 * t;
+      return (-60 * t + 180 * t2 - 120 * t3) * p0 + (-36 * t + 96 * t2 - 60 * t3) * v0 +
+             (1 - 9 * t + 18 * t2 - 10 * t3) * a0 + (60 * t - 180 * t2 + 120 * t3) * p1 +
+             (-24 * t + 84 * t2 - 60 * t3) * v1 + (3 * t - 12 * t2 + 10 * t3) * a1;
+    }
+  };
+
+  // Uniform Catmull-Rom through every point (N >= 2); end tangents mirror the
+  // neighbouring point, so the path starts and ends along its first/last leg
+  template <int N>
+  struct CatmullRom {
+    static_assert(N >= 2, "Catmull-Rom needs at least two points");
+    Waypoint pts[N];
+
+    constexpr Waypoint point(double t) const { return eval(t, 0); }
+    constexpr Waypoint d1(double t) const { return eval(t, 1); }
+    constexpr Waypoint d2(double t) const { return eval(t, 2); }
+
+  private:
+    constexpr Waypoint at(int i) const {
+      if (i < 0) return 2.0 * pts[0] - pts[1];
+      if (i >= N) return 2.0 * pts[N - 1] - pts[N - 2];
+      return pts[i];
+    }
+
+    // Segment i runs pts[i] -> pts[i + 1]; derivatives are per unit t
+    // across the whole curve, hence the (N - 1) factors
+    constexpr Waypoint eval(double t, int order) const {
+      const double u = t * (N - 1);
+      int i = (int)u;
+      if (i > N - 2) i = N - 2;
+      const double s = u - i;
+      const Waypoint a = at(i - 1), b = at(i), c = at(i + 1), d = at(i + 2);
+
+      const Waypoint c1 = 0.5 * (c - a);
+      const Waypoint c2 = 0.5 * (2.0 * a - 5.0 * b + 4.0 * c - d);
+      const Waypoint c3 = 0.5 * (3.0 * b - a - 3.0 * c + d);
+      const double k = N - 1;
+      if (order == 0) return b + s * c1 + (s * s) * c2 + (s * s * s) * c3;
+      if (order == 1) return k * (c1 + (2 * s) * c2 + (3 * s * s) * c3);
+      return (k * k) * (2.0 * c2 + (6 * s) * c3);
+    }
+  };
+
+  // N segments end to end, each taking 1/N of t. Chained QuinticHermites
+  // pass through fixed points at a chosen heading and curvature.
+  template <typename Segment, int N>
+  struct Chain {
+    static_assert(N >= 1, "a chain needs at least one segment");
+    Segment segs[N];
+
+    constexpr Waypoint point(double t) const { return segs[index(t)].point(local(t)); }
+    constexpr Waypoint d1(double t) const { return (double)N * segs[index(t)].d1(local(t)); }
+    constexpr Waypoint d2(double t) const { return (double)(N * N) * segs[index(t)].d2(local(t)); }
+
+  private:
+    constexpr int index(double t) const {
+      const int i = (int)(t * N);
+      return i > N - 1 ? N - 1 : i;
+    }
+    constexpr double local(double t) const { return t * N - index(t); }
+  };
+
+  struct Limits {
+    double maxVelInPerS = 55.0;
+    double maxAccelInPerS2 = 120.0;
+    double maxLateralAccelInPerS2 = 100.0;   // v^2 * curvature
+  };
+
+  // N points at equal arc length, s[] from 0 to length
+  template <int N>
+  struct BakedPath {
+    static_assert(N >= 2, "a path needs at least two points");
+
+    Waypoint pts[N];
+    double s[N];
+    double curvature[N];    // 1/in, + toward +theta
+    double velocity[N];     // in/s, from rest to rest
+    double maxVelInPerS;
+
+    constexpr int size() const { return N; }
+    constexpr double length() const { return s[N - 1]; }
+    constexpr PathView view() const { return PathView{pts, s, velocity, N, maxVelInPerS}; }
+  };
+
+  template <int N, typename Curve>
+  constexpr BakedPath<N> bake(const Curve& curve, const Limits& limits = {}) {
+    // Dense table of chord lengths, then walk it to place equal-s samples
+    constexpr int DENSE = 32 * (N - 1);
+    double dense[DENSE + 1]{};
+    Waypoint prev = curve.point(0.0);
+    for (int k = 1; k <= DENSE; k++) {
+      const Waypoint p = curve.point((double)k / DENSE);
+      const Waypoint d = p - prev;
+      dense[k] = dense[k - 1] + sqrt(d.x * d.x + d.y * d.y);
+      prev = p;
+    }
+
+    BakedPath<N> out{};
+    out.maxVelInPerS = limits.maxVelInPerS;
+    const double total = dense[DENSE];
+    int k = 0;
+    for (int i = 0; i < N; i++) {
+      const double target = total * i / (N - 1);
+      while (k < DENSE - 1 && dense[k + 1] < target) k++;
+      const double span = dense[k + 1] - dense[k];
+      const double frac = span > 0 ? (target - dense[k]) / span : 0.0;
+      const double t = (k + frac) / DENSE;
+
+      const Waypoint p = curve.point(t);
+      const Waypoint v = curve.d1(t);
+      const Waypoint a = curve.d2(t);
+      const double speed = sqrt(v.x * v.x + v.y * v.y);
+
+      out.pts[i] = p;
+      out.s[i] = target;
+      out.curvature[i] = speed > 1e-9 ? (v.x * a.y - v.y * a.x) / (speed * speed * speed) : 0.0;
+
+      // Cornering limit first; accel limits below
+      const double kAbs = abs(out.curvature[i]);
+      double cap = limits.maxVelInPerS;
+      if (kAbs > 1e-9 && limits.maxLateralAccelInPerS2 / kAbs < cap * cap) {
+        cap = sqrt(limits.maxLateralAccelInPerS2 / kAbs);
+      }
+      out.velocity[i] = cap;
+    }
+
+    // Forward pass from rest, backward pass to rest: v^2 <= v_prev^2 + 2 a ds
+    out.velocity[0] = 0.0;
+    for (int i = 1; i < N; i++) {
+      const double reach = sqrt(out.velocity[i - 1] * out.velocity[i - 1] +
+                                2 * limits.maxAccelInPerS2 * (out.s[i] - out.s[i - 1]));
+      if (reach < out.velocity[i]) out.velocity[i] = reach;
+    }
+    out.velocity[N - 1] = 0.0;
+    for (int i = N - 2; i >= 0; i--) {
+      const double reach = sqrt(out.velocity[i + 1] * out.velocity[i + 1] +
+                                2 * limits.maxAccelInPerS2 * (out.s[i + 1] - out.s[i]));
+      if (reach < out.velocity[i]) out.velocity[i] = reach;
+    }
+    return out;
+  }
+
+  // For static_assert: every sample keeps the robot marginIn off the walls
+  template <int N>
+  constexpr bool insideField(const BakedPath<N>& path, double marginIn) {
+    for (int i = 0; i < N; i++) {
+      if (!field::inside(path.pts[i].x, path.pts[i].y, marginIn)) return false;
+    }
+    return true;
+  }
+
+  // For static_assert: tightest turn radius the drive can follow
+  template <int N>
+  constexpr bool minRadius(const BakedPath<N>& path, double radiusIn) {
+    for (int i = 0; i < N; i++) {
+      if (abs(path.curvature[i]) * radiusIn > 1.0) return false;
+    }
+    return true;
+  }
+
+  // For static_assert: consecutive samples closer than PurePursuit's lookahead
+  template <int N>
+  constexpr bool maxSpacing(const BakedPath<N>& path, double spacingIn) {
+    return path.length() / (N - 1) <= spacingIn;
+  }
+}
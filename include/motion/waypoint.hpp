@@ -0,0 +1,16 @@
+#pragma once
+
+struct Waypoint {
+  double x;  // inches
+  double y;  // inches
+};
+
+// A path that already knows its arc lengths and speed profile, e.g. one
+// baked at compile time by spline::bake. Points at storage it doesn't own.
+struct PathView {
+  const Waypoint* pts;
+  const double* s;            // arc length at each point
+  const double* velocity;     // in/s, scaled against maxVelInPerS for voltage
+  int count;
+  double maxVelInPerS;
+};
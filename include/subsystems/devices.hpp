@@ -1,18 +1,26 @@
 #pragma once
 #include "pros/misc.hpp"
 #include "drive/drive.hpp"
+#include "drive/thermal.hpp"
 #include "localization/odom.hpp"
+#include "localization/mcl.hpp"
 #include "motion/motion.hpp"
 
 // Global odometry instance
 extern Odom odom;
 
+// Distance-sensor localization (started only if USE_MCL)
+extern Mcl mcl;
+
 // Global controller
 extern pros::Controller master;
 
 // Global subsystems
 extern Drive drive;
 
+// Drive motor temperature model and power budget
+extern Thermal thermal;
+
 // Global motion controller
 extern Motion motion;
 
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdint>
+
+// On-disk telemetry log format, shared by the brain-side writer and the
+// native decoder (tools/tlm_decode.cpp). Little-endian, no padding.
+//
+//   header:  "ZTLM" u16 version u16 fieldsPerRecord
+//   chunks:  u8 tag, then
+//     'C'  u8 channel, u8 nameLen, name, u8 fieldsLen, fields ("x,y,theta")
+//     'R'  u8 channel, u32 timeUs, f32 value[fieldsPerRecord]
+//     'D'  u8 channel, u32 records dropped since the last 'D'
+//
+// A channel's 'C' chunk always comes before its first 'R'.
+namespace telemetry {
+  constexpr char MAGIC[4] = {'Z', 'T', 'L', 'M'};
+  constexpr std::uint16_t VERSION = 1;
+  constexpr int FIELDS = 6;
+
+  constexpr std::uint8_t TAG_CHANNEL = 'C';
+  constexpr std::uint8_t TAG_RECORD = 'R';
+  constexpr std::uint8_t TAG_DROPPED = 'D';
+
+  struct Record {
+    std::uint32_t timeUs;
+    float value[FIELDS];
+  };
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "telemetry/format.hpp"
+#include "util/spsc_ring.hpp"
+#include <atomic>
+#include <cstdint>
+
+// Binary match logging. Control loops push fixed-size records into their own
+// lock-free ring (a 28-byte copy plus one atomic store, never blocks); a
+// low-priority task drains every ring to a file. Records pushed before
+// start() are discarded.
+//
+// Channels must be objects with static storage duration, one producer each:
+//   static telemetry::Channel odomLog("odom", "x,y,theta");
+//   odomLog.log(p.x, p.y, p.theta);
+namespace telemetry {
+  constexpr int MAX_CHANNELS = 16;
+
+  class Channel {
+  public:
+    Channel(const char* name, const char* fields);
+
+    void log(float a, float b = 0, float c = 0, float d = 0, float e = 0, float f = 0);
+
+    const char* name() const { return nameStr; }
+    const char* fields() const { return fieldsStr; }
+    int id() const { return slot; }
+
+    // Writer side
+    bool pop(Record& out) { return ring.pop(out); }
+    std::uint32_t takeDropped() { return dropped.exchange(0, std::memory_order_relaxed); }
+
+  private:
+    const char* nameStr;
+    const char* fieldsStr;
+    int slot;
+    SpscRing<Record, 64> ring;          // ~0.6s at 100Hz
+    std::atomic<std::uint32_t> dropped{0};
+  };
+
+  // Opens the next free <dir>tlm_NNN.bin and starts the writer task.
+  // Returns false if no file could be opened (e.g. no SD card).
+  bool start(const char* dir = "/usd/");
+  bool running();
+}
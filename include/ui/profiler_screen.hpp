@@ -0,0 +1,7 @@
+#pragma once
+
+// LLEMU view of the profiler: lines 3-7 page through sections every 2 s.
+// The left LCD button dumps the full table to the serial terminal.
+namespace profiler_screen {
+  void init();  // start background task
+}
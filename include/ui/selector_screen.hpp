@@ -0,0 +1,12 @@
+#pragma once
+
+// Touchscreen auton selector: a tile per routine and a field preview of the
+// selected route. Taps go through auton_selector, so the controller (L1/L2,
+// X to lock) and the screen always agree.
+//
+// The field is drawn once into a canvas; after that only the route line and
+// the tiles that change state are invalidated. The "LCD" tile shows the
+// LLEMU lines (profiler etc.); the center LCD button comes back.
+namespace selector_screen {
+  void init();  // after pros::lcd::initialize() and the auton selector
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+// Fixed-size row-major matrix on the stack. Sizes are compile-time so the
+// estimator code never allocates; trivially copyable so it fits a SeqLock.
+template <int R, int C>
+struct Mat {
+  double m[R][C]{};
+
+  static Mat identity() {
+    static_assert(R == C, "identity needs a square matrix");
+    Mat out;
+    for (int i = 0; i < R; i++) out.m[i][i] = 1.0;
+    return out;
+  }
+
+  double& operator()(int r, int c) { return m[r][c]; }
+  double operator()(int r, int c) const { return m[r][c]; }
+
+  Mat<C, R> transpose() const {
+    Mat<C, R> out;
+    for (int r = 0; r < R; r++)
+      for (int c = 0; c < C; c++) out.m[c][r] = m[r][c];
+    return out;
+  }
+
+  Mat operator+(const Mat& o) const {
+    Mat out;
+    for (int r = 0; r < R; r++)
+      for (int c = 0; c < C; c++) out.m[r][c] = m[r][c] + o.m[r][c];
+    return out;
+  }
+
+  Mat operator-(const Mat& o) const {
+    Mat out;
+    for (int r = 0; r < R; r++)
+      for (int c = 0; c < C; c++) out.m[r][c] = m[r][c] - o.m[r][c];
+    return out;
+  }
+
+  template <int K>
+  Mat<R, K> operator*(const Mat<C, K>& o) const {
+    Mat<R, K> out;
+    for (int r = 0; r < R; r++)
+      for (int k = 0; k < K; k++) {
+        double sum = 0.0;
+        for (int c = 0; c < C; c++) sum += m[r][c] * o.m[c][k];
+        out.m[r][k] = sum;
+      }
+    return out;
+  }
+};
@@ -0,0 +1,68 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Single-writer, multi-reader latest-value cell. Neither side ever blocks.
+//
+// Two seqlock-protected buffers: the writer always fills the one readers
+// aren't pointed at, then flips the index. A reader only retries if the
+// writer lapped it (two full writes during one copy), so a high-priority
+// reader can't spin on a preempted low-priority writer.
+//
+// Payload is copied through relaxed atomic words so torn copies are detected
+// by the sequence check instead of being a data race.
+template <typename T>
+class SeqLock {
+  static_assert(std::is_trivially_copyable_v<T>, "SeqLock payload must be trivially copyable");
+
+public:
+  SeqLock() = default;
+  explicit SeqLock(const T& initial) { store(initial); }
+
+  // Only ever call from one task at a time
+  void store(const T& value) {
+    std::uint32_t buf[WORDS]{};
+    std::memcpy(buf, &value, sizeof(T));
+
+    Buffer& b = buffers[active.load(std::memory_order_relaxed) ^ 1u];
+    const std::uint32_t s = b.seq.load(std::memory_order_relaxed);
+    b.seq.store(s + 1, std::memory_order_relaxed);        // odd = writing
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t i = 0; i < WORDS; i++) b.words[i].store(buf[i], std::memory_order_relaxed);
+    b.seq.store(s + 2, std::memory_order_release);
+
+    active.store(active.load(std::memory_order_relaxed) ^ 1u, std::memory_order_release);
+  }
+
+  // retries, if given, counts copies thrown away because the writer lapped us
+  T load(std::uint32_t* retries = nullptr) const {
+    std::uint32_t buf[WORDS];
+    while (true) {
+      const Buffer& b = buffers[active.load(std::memory_order_acquire)];
+      const std::uint32_t s0 = b.seq.load(std::memory_order_acquire);
+      for (std::size_t i = 0; i < WORDS; i++) buf[i] = b.words[i].load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      const std::uint32_t s1 = b.seq.load(std::memory_order_relaxed);
+      if (s0 == s1 && !(s0 & 1u)) break;
+      if (retries) (*retries)++;
+    }
+
+    T out;
+    std::memcpy(&out, buf, sizeof(T));
+    return out;
+  }
+
+private:
+  static constexpr std::size_t WORDS = (sizeof(T) + 3) / 4;
+
+  struct Buffer {
+    std::atomic<std::uint32_t> seq{0};
+    std::atomic<std::uint32_t> words[WORDS]{};
+  };
+
+  Buffer buffers[2];
+  std::atomic<std::uint32_t> active{0};
+};
@@ -0,0 +1,30 @@
+#pragma once
+#include <atomic>
+#include <cstring>
+
+// Lock-free registration in a fixed table whose slots are keyed by an
+// atomic pointer (nullptr = free). A key equal to one already present gets
+// that slot back, so per-call users (turnTo's loop etc.) accumulate in one
+// place; otherwise the first free slot is claimed by CAS. Returns -1 when
+// the table is full.
+//
+// keyAt(i) returns the slot's std::atomic<T*>&; same(a, b) compares keys.
+template <typename T, typename KeyAt, typename Same>
+int claimSlot(int count, T* key, KeyAt keyAt, Same same) {
+  for (int i = 0; i < count; i++) {
+    T* k = keyAt(i).load();
+    if (k && same(k, key)) return i;
+  }
+  for (int i = 0; i < count; i++) {
+    T* expected = nullptr;
+    if (keyAt(i).compare_exchange_strong(expected, key)) return i;
+    if (same(expected, key)) return i;   // raced with an equal key
+  }
+  return -1;
+}
+
+// Keyed by name string contents, not the pointer
+template <typename KeyAt>
+int claimNamedSlot(int count, const char* name, KeyAt keyAt) {
+  return claimSlot(count, name, keyAt, [](const char* a, const char* b) { return std::strcmp(a, b) == 0; });
+}
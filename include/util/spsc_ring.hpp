@@ -0,0 +1,39 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Bounded lock-free single-producer/single-consumer queue.
+// push() and pop() never block; push() fails when full. N must be a power of two.
+template <typename T, std::size_t N>
+class SpscRing {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing size must be a power of two");
+
+public:
+  // Producer side
+  bool push(const T& item) {
+    const std::uint32_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) >= N) return false;
+    slots[h & (N - 1)] = item;
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side
+  bool pop(T& out) {
+    const std::uint32_t t = tail.load(std::memory_order_relaxed);
+    if (t == head.load(std::memory_order_acquire)) return false;
+    out = slots[t & (N - 1)];
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  std::size_t size() const {
+    return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+  }
+
+private:
+  T slots[N];
+  std::atomic<std::uint32_t> head{0};  // next write, producer owned
+  std::atomic<std::uint32_t> tail{0};  // next read, consumer owned
+};
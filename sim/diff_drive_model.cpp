@@ -0,0 +1,109 @@
+#include "diff_drive_model.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace sim {
+
+DiffDriveModel::DiffDriveModel(const DiffDriveParams& params)
+  : p(params), leftTemp(params.startTempC), rightTemp(params.startTempC), batteryNow(params.batteryVolts) {}
+
+void DiffDriveModel::setVoltage(double leftMv, double rightMv) {
+  leftVolts = leftMv / 1000.0;
+  rightVolts = rightMv / 1000.0;
+}
+
+void DiffDriveModel::setPose(double xM, double yM, double thetaRad) {
+  x = xM;
+  y = yM;
+  theta = thetaRad;
+  v = omega = 0.0;
+  leftWheelRadS = rightWheelRadS = 0.0;
+}
+
+double DiffDriveModel::motorTorque(double volts, double motorRadS, double tempC) const {
+  // Linear DC motor curve; zero volts in coast means the driver floats the
+  // windings, anything else (including brake/hold) shorts them through the H-bridge.
+  if (volts == 0.0 && !brakeHold) return 0.0;
+
+  const double t = p.motorStallTorqueNm * (volts / p.nominalVolts - motorRadS / p.motorFreeSpeedRadS);
+  // Firmware current limit caps torque at roughly stall, half that when hot
+  const double limit = tempC >= p.throttleC ? p.motorStallTorqueNm / 2.0 : p.motorStallTorqueNm;
+  return std::clamp(t, -limit, limit);
+}
+
+void DiffDriveModel::heat(double& tempC, double amps, double dt) const {
+  const double watts = amps * amps * p.windingOhm;
+  tempC += (watts - (tempC - p.ambientC) / p.thermalResKPerW) / p.thermalCapJPerK * dt;
+}
+
+void DiffDriveModel::step(double dtSec) {
+  // Slip dynamics are stiff; keep explicit Euler well inside its stable region
+  constexpr int SUBSTEPS = 4;
+  for (int i = 0; i < SUBSTEPS; i++) substep(dtSec / SUBSTEPS);
+}
+
+void DiffDriveModel::substep(double dt) {
+  const double halfTrack = p.trackWidthM / 2.0;
+  const double r = p.wheelRadiusM;
+  const double maxForce = p.traction * p.massKg * 9.81 / 2.0; // per side
+
+  // Contact patch ground speed per side (clockwise yaw speeds up the left side)
+  const double groundL = v + omega * halfTrack;
+  const double groundR = v - omega * halfTrack;
+
+  auto sideForce = [&](double wheelRadS, double groundMps) {
+    const double slip = wheelRadS * r - groundMps;
+    return std::clamp(p.slipStiffnessNsPerM * slip, -maxForce, maxForce);
+  };
+  const double forceL = sideForce(leftWheelRadS, groundL);
+  const double forceR = sideForce(rightWheelRadS, groundR);
+
+  // Current follows torque; heating uses it per motor
+  const double ampsPerNm = p.motorStallCurrentA / p.motorStallTorqueNm;
+  auto sideTorque = [&](double volts, double wheelRadS, double tempC, double& amps) {
+    const double motorNm = motorTorque(volts, wheelRadS / p.wheelPerMotor, tempC);
+    amps = std::abs(motorNm) * ampsPerNm;
+    return p.motorsPerSide * motorNm / p.wheelPerMotor;
+  };
+
+  // The motors' mV are 12 V full scale, so what reaches the windings
+  // follows the battery (sagging with the last substep's current)
+  const double supply = batteryNow / p.nominalVolts;
+  const double torqueL = sideTorque(leftVolts * supply, leftWheelRadS, leftTemp, leftAmps);
+  const double torqueR = sideTorque(rightVolts * supply, rightWheelRadS, rightTemp, rightAmps);
+  batteryNow = p.batteryVolts - p.batteryOhm * p.motorsPerSide * (leftAmps + rightAmps);
+  heat(leftTemp, leftAmps, dt);
+  heat(rightTemp, rightAmps, dt);
+
+  const double accelL = (torqueL - forceL * r - p.sideFrictionNmS * leftWheelRadS) / p.sideInertiaKgM2;
+  const double accelR = (torqueR - forceR * r - p.sideFrictionNmS * rightWheelRadS) / p.sideInertiaKgM2;
+
+  const double linAccel = (forceL + forceR + pushN - p.rollingDragNsPerM * v) / p.massKg;
+  const double yawAccel = ((forceL - forceR) * halfTrack - p.yawDragNmsPerRad * omega) / p.yawInertiaKgM2;
+
+  leftWheelRadS += accelL * dt;
+  rightWheelRadS += accelR * dt;
+  leftWheelRad += leftWheelRadS * dt;
+  rightWheelRad += rightWheelRadS * dt;
+
+  accel = linAccel;
+  v += linAccel * dt;
+  omega += yawAccel * dt;
+
+  x += v * std::cos(theta) * dt;
+  y += v * std::sin(theta) * dt;
+  theta += omega * dt;
+
+  distance += v * dt;
+  yaw += omega * dt;
+}
+
+double DiffDriveModel::leftMotorDeg() const {
+  return leftWheelRad / p.wheelPerMotor * 180.0 / M_PI;
+}
+
+double DiffDriveModel::rightMotorDeg() const {
+  return rightWheelRad / p.wheelPerMotor * 180.0 / M_PI;
+}
+
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+namespace sim {
+  // Physical parameters, SI units. Defaults approximate our 6x blue-cartridge
+  // drive on 2.75" wheels geared 600 -> 450 rpm.
+  struct DiffDriveParams {
+    double massKg = 6.8;
+    double yawInertiaKgM2 = 0.16;
+    double trackWidthM = 12.5 * 0.0254;
+    double wheelRadiusM = 2.75 / 2.0 * 0.0254;
+
+    int motorsPerSide = 3;
+    double motorStallTorqueNm = 0.35;   // per motor, at the 600 rpm output shaft
+    double motorFreeSpeedRadS = 600.0 * 2.0 * 3.141592653589793 / 60.0;
+    double nominalVolts = 12.0;
+    double batteryVolts = 12.0;         // open circuit; commands are a duty cycle of the terminal voltage
+    double batteryOhm = 0.03;           // sag under load
+    double wheelPerMotor = 0.75;        // external gearing (wheel = motor * 0.75)
+
+    double sideInertiaKgM2 = 0.002;     // wheels + gearing + rotors, reflected to the wheel
+    double sideFrictionNmS = 0.004;     // viscous loss in the gear train
+
+    double traction = 0.35;              // tyre friction coefficient
+    double slipStiffnessNsPerM = 800.0; // contact force per m/s of slip, before saturating
+    double rollingDragNsPerM = 1.5;
+    double yawDragNmsPerRad = 0.05;
+
+    // Motor heating, one lump per side (the three motors share the load)
+    double motorStallCurrentA = 2.5;
+    double windingOhm = 4.8;
+    double thermalResKPerW = 6.0;       // to ambient
+    double thermalCapJPerK = 20.0;
+    double ambientC = 25.0;
+    double startTempC = 25.0;
+    double throttleC = 55.0;            // firmware halves the current limit
+  };
+
+  // Planar differential-drive rigid body with per-side DC motor torque curves,
+  // side inertia and a saturating tyre slip model. Heading follows the IMU
+  // convention used by Odom (clockwise positive, x/y rotated by theta).
+  class DiffDriveModel {
+  public:
+    explicit DiffDriveModel(const DiffDriveParams& params = {});
+
+    void setVoltage(double leftMv, double rightMv);
+    void setBrakeHold(bool enabled) { brakeHold = enabled; }
+    void setPushForce(double forwardN) { pushN = forwardN; }   // another robot, body frame
+    void step(double dtSec);
+
+    // Ground truth
+    double xM() const { return x; }
+    double yM() const { return y; }
+    double thetaRad() const { return theta; }
+    double velocityMps() const { return v; }
+    double yawRateRadS() const { return omega; }
+    double accelMps2() const { return accel; }      // body-frame forward
+    double distanceM() const { return distance; }   // signed path length of the body center
+    double headingTravelRad() const { return yaw; }  // unwrapped, unaffected by setPose
+
+    // Motor shaft angle per side in degrees (what integrated encoders report)
+    double leftMotorDeg() const;
+    double rightMotorDeg() const;
+
+    void setPose(double xM, double yM, double thetaRad);
+
+    // Per motor on each side
+    double leftTempC() const { return leftTemp; }
+    double rightTempC() const { return rightTemp; }
+    double leftCurrentA() const { return leftAmps; }
+    double rightCurrentA() const { return rightAmps; }
+    double batteryVoltsNow() const { return batteryNow; }
+    bool throttled() const { return leftTemp >= p.throttleC || rightTemp >= p.throttleC; }
+
+  private:
+    void substep(double dt);
+    double motorTorque(double volts, double motorRadS, double tempC) const;
+    void heat(double& tempC, double amps, double dt) const;
+
+    DiffDriveParams p;
+    bool brakeHold{false};
+    double pushN{0.0};
+    double leftVolts{0.0}, rightVolts{0.0};
+
+    double x{0.0}, y{0.0}, theta{0.0};
+    double v{0.0}, omega{0.0}, accel{0.0};
+    double distance{0.0}, yaw{0.0};
+
+    double leftWheelRadS{0.0}, rightWheelRadS{0.0};
+    double leftWheelRad{0.0}, rightWheelRad{0.0};
+
+    double leftTemp, rightTemp;
+    double leftAmps{0.0}, rightAmps{0.0};
+    double batteryNow;
+  };
+}
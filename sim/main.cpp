@@ -0,0 +1,320 @@
+// Native scenario runner: real Drive/Odom/Motion code against the physics model.
+//
+//   make sim && ./bin/native/zeez-sim turn:90 drive:24 point:24,24
+//
+// Commands run in order, each printing elapsed sim time, odom pose and true pose.
+#include "sim_runtime.hpp"
+#include "sim_drive_io.hpp"
+#include "sim_tracking_io.hpp"
+#include "sim_gps_io.hpp"
+#include "sim_distance_io.hpp"
+#include "config/constants.hpp"
+#include "telemetry/telemetry.hpp"
+#include "control/profiler.hpp"
+#include "drive/drive.hpp"
+#include "drive/autotune.hpp"
+#include "drive/sysid.hpp"
+#include "drive/thermal.hpp"
+#include "auton/script.hpp"
+#include "auton/recorder.hpp"
+#include "auton/paths.hpp"
+#include "control/executive.hpp"
+#include "localization/odom.hpp"
+#include "localization/mcl.hpp"
+#include "motion/motion.hpp"
+#include "motion/spline.hpp"
+#include "hal/rtos.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+  constexpr double M_TO_IN = 1.0 / 0.0254;
+
+  void usage() {
+    std::printf("usage: zeez-sim [--motors|--tracking] [--gps|--mcl] [--start=<x>,<y>] [--wheel-error=<pct>] [--traction=<mu>] [--temp=<C>] [--battery=<V>] [--deadline=<s>] [--script=<file>] [--log=<dir/>] [--profile] cmd...\n"
+                "  --log=<dir/>    write telemetry tlm_NNN.bin into dir\n"
+                "  --profile       print profiler table at exit (virtual clock: counts only)\n"
+                "  --motors        odom from drive encoders + IMU\n"
+                "  --tracking      odom from tracking wheels\n"
+                "  --gps           fuse a simulated GPS (0.5 in error, GPS_LATENCY_MS late)\n"
+                "  --mcl           fuse Monte Carlo localization from simulated distance sensors\n"
+                "  --start=<x>,<y> robot really starts here; odom still thinks (0, 0).\n"
+                "                  With --mcl, particles start spread over the whole field\n"
+                "  --wheel-error=<pct> tracking wheels read pct%% long (odom drift)\n"
+                "  --traction=<mu> tyre friction coefficient (default 0.35)\n"
+                "  --temp=<C>      drive motors start this hot (default 25)\n"
+                "  --battery=<V>   open-circuit battery voltage (default 12.0)\n"
+                "  --deadline=<s>  Thermal budgets drive power to last s seconds\n"
+                "  --script=<file> load auton routes (script.hpp format); 'intake' is bound\n"
+                "  turn:<deg>      Drive::turnTo\n"
+                "  drive:<in>      Drive::driveDistance\n"
+                "  point:<x>,<y>   Motion::driveToPoint\n"
+                "  pose:<x>,<y>,<deg> Motion::driveToPose\n"
+                "  path:<x>,<y>;.. Motion::followPath\n"
+                "  spline          Motion::followPath on the baked skills route (paths::skills) from (0, 0)\n"
+                "  tune            autotune::run (turn, distance + pose gains)\n"
+                "  sysid           sysid::run (linear + angular kS/kV/kA)\n"
+                "  wait:<ms>       idle\n"
+                "  script:<name>   script::run on a route from --script\n"
+                "  record:<file>   recorder: 5 s of canned driver sticks, saved to file\n"
+                "  replay:<file>   recorder::replay with drift correction (replay-open: without)\n"
+                "  hammer:<s>      full-power shuttle runs for s seconds, thermal report every 10 s\n"
+                "  unplug:<ms>     tracking wheel reads fail from ms into the next command on\n"
+                "  push:<N>        another robot pushes along our heading (+ forward) until push:0\n"
+                "  async:<in>@<frac> driveDistanceAsync, cancelled at progress frac\n"
+                "  async:<in>      driveDistanceAsync left running; the next move takes over\n");
+  }
+
+  std::vector<Waypoint> parsePath(const char* s) {
+    std::vector<Waypoint> path;
+    double x, y;
+    int n = 0;
+    while (std::sscanf(s, "%lf,%lf%n", &x, &y, &n) == 2) {
+      path.push_back(Waypoint{x, y});
+      s += n;
+      if (*s != ';') break;
+      s++;
+    }
+    return path;
+  }
+
+  constexpr auto SPLINE_PATH = paths::skills(Pose{0, 0, 0});
+
+  // Odom fuses Mcl and Mcl reads Odom; a member's address is usable before
+  // it's constructed, locals' aren't
+  struct Localization {
+    Odom odom;
+    Mcl mcl;
+
+    Localization(Drive& drive, hal::TrackingIO* tracking, hal::GpsIO* gps, bool useMcl, hal::DistanceIO& distance)
+      : odom(drive, tracking, useMcl ? &mcl : gps), mcl(odom, distance) {}
+  };
+
+  void simIntake(double value) {
+    std::printf("  intake %.0f at %u ms\n", value, hal::millis());
+  }
+
+  // Stand-in for a driver: full-speed straights and a sweeping turn
+  void recordDriver(Drive& drive, Odom& odom, const char* path) {
+    FixedRate rate("opcontrol", recorder::RATE_MS);
+    recorder::start(odom.get());
+    for (std::uint32_t t = 0; t < 5000; t += recorder::RATE_MS) {
+      const int forward = t < 1500 ? 90 : t < 2700 ? 60 : t < 4400 ? 90 : 0;
+      const int turn = t >= 1500 && t < 2700 ? 30 : 0;
+      drive.arcade(forward, turn);
+      recorder::record(drive.commandedLeftMv(), drive.commandedRightMv(), 0, odom.get());
+      rate.wait();
+    }
+    recorder::stop();
+    drive.setVoltage(0, 0);
+    if (!recorder::save(path)) std::printf("can't save %s\n", path);
+  }
+
+  // Full stick forward and back, like a driver crossing the field all match
+  void hammer(Drive& drive, const Thermal& thermal, const sim::DiffDriveModel& model, double seconds) {
+    FixedRate rate("opcontrol", 10);
+    for (std::uint32_t t = 0; t < seconds * 1000; t += 10) {
+      drive.arcade((t / 800) % 2 ? -100 : 100, 0);
+      if (t % 10000 == 0) {
+        const Thermal::Status s = thermal.status();
+        std::printf("  %5.1f s  true %5.1f C  model %5.1f C (sensor %2.0f)  %.2f A  to limit %6.1f s  budget %.2f%s\n",
+                    t / 1000.0, model.leftTempC(), s.left.tempC, s.left.sensorC, s.left.currentA,
+                    s.left.timeToLimitS, s.budget, model.throttled() ? "  THROTTLED" : "");
+      }
+      rate.wait();
+    }
+    drive.setVoltage(0, 0);
+  }
+
+  void report(const char* cmd, std::uint32_t startMs, const Odom& odom, const sim::DiffDriveModel& model) {
+    const Pose p = odom.get();
+    std::printf("%-16s %6u ms  odom (%7.2f, %7.2f, %7.2f deg)  true (%7.2f, %7.2f, %7.2f deg)\n",
+                cmd, hal::millis() - startMs,
+                p.x, p.y, p.theta * 180.0 / M_PI,
+                model.xM() * M_TO_IN, model.yM() * M_TO_IN, model.thetaRad() * 180.0 / M_PI);
+  }
+}
+
+int main(int argc, char** argv) {
+  bool useTracking = constants::USE_TRACKING_WHEELS;
+  const char* logDir = nullptr;
+  bool profile = false;
+  bool useGps = false;
+  bool useMcl = false;
+  double startX = 0.0, startY = 0.0;
+  double wheelErrorPct = 0.0;
+  double deadlineS = 0.0;
+  sim::DiffDriveParams params;
+  const char* scriptPath = nullptr;
+  int first = 1;
+  for (; first < argc && argv[first][0] == '-'; first++) {
+    if (std::strcmp(argv[first], "--motors") == 0) useTracking = false;
+    else if (std::strcmp(argv[first], "--tracking") == 0) useTracking = true;
+    else if (std::strncmp(argv[first], "--log=", 6) == 0) logDir = argv[first] + 6;
+    else if (std::strcmp(argv[first], "--profile") == 0) profile = true;
+    else if (std::strcmp(argv[first], "--gps") == 0) useGps = true;
+    else if (std::strcmp(argv[first], "--mcl") == 0) useMcl = true;
+    else if (std::sscanf(argv[first], "--start=%lf,%lf", &startX, &startY) == 2) {}
+    else if (std::sscanf(argv[first], "--wheel-error=%lf", &wheelErrorPct) == 1) {}
+    else if (std::sscanf(argv[first], "--traction=%lf", &params.traction) == 1) {}
+    else if (std::sscanf(argv[first], "--temp=%lf", &params.startTempC) == 1) {}
+    else if (std::sscanf(argv[first], "--battery=%lf", &params.batteryVolts) == 1) {}
+    else if (std::sscanf(argv[first], "--deadline=%lf", &deadlineS) == 1) {}
+    else if (std::strncmp(argv[first], "--script=", 9) == 0) scriptPath = argv[first] + 9;
+    else {
+      usage();
+      return 1;
+    }
+  }
+  if (first >= argc) {
+    usage();
+    return 1;
+  }
+
+  sim::attachMainThread();
+
+  if (scriptPath) {
+    script::bindMechanism("intake", simIntake);
+    if (!script::load(scriptPath)) {
+      std::printf("%s: %s\n", scriptPath, script::error()[0] ? script::error() : "can't open or no autons");
+      return 1;
+    }
+    for (int i = 0; i < script::routeCount(); i++) std::printf("route %d: %s\n", i, script::routeName(i));
+  }
+
+  sim::DiffDriveModel model(params);
+  sim::SimDriveIO io(model);
+  sim::SimTrackingIO tracking(model, 1.0 + wheelErrorPct / 100.0);
+  sim::SimGpsIO gps(model);
+  sim::SimDistanceIO distance(model);
+  const bool unknownStart = startX != 0.0 || startY != 0.0;
+  model.setPose(startX / M_TO_IN, startY / M_TO_IN, 0.0);
+  // The hook runs under the runtime's lock, so it keeps its own clock
+  std::uint64_t physicsUs = sim::nowUs();
+  std::uint64_t unplugUs = 0;
+  sim::setStepHook([&model, &gps, &tracking, &physicsUs, &unplugUs](double dt) {
+    model.step(dt);
+    physicsUs += (std::uint64_t)std::llround(dt * 1e6);
+    gps.record((std::uint32_t)(physicsUs / 1000));
+    if (unplugUs != 0 && physicsUs >= unplugUs) tracking.unplug();
+  });
+
+  Drive drive(io);
+  Localization loc(drive, useTracking ? &tracking : nullptr, useGps ? &gps : nullptr, useMcl, distance);
+  Odom& odom = loc.odom;
+  Motion motion(drive, odom);
+  Thermal thermal(drive);
+
+  // Same bring-up as initialize()
+  drive.calibrateImu();
+  odom.start();
+  thermal.start();
+  odom.reset(Pose{0, 0, 0});
+  if (useMcl) {
+    if (unknownStart) loc.mcl.initGlobal(0.0);
+    else loc.mcl.initAround(Pose{0, 0, 0});
+    loc.mcl.start();
+  }
+  if (logDir && !telemetry::start(logDir)) std::printf("can't open log in %s\n", logDir);
+
+  if (deadlineS > 0) thermal.setDeadline(hal::millis() + (std::uint32_t)(deadlineS * 1000));
+
+  const auto wallStart = std::chrono::steady_clock::now();
+  const std::uint32_t simStart = hal::millis();
+
+  for (int i = first; i < argc; i++) {
+    const char* cmd = argv[i];
+    const std::uint32_t startMs = hal::millis();
+    double a = 0, b = 0, c = 0;
+
+    if (std::sscanf(cmd, "turn:%lf", &a) == 1) drive.turnTo(a);
+    else if (std::sscanf(cmd, "drive:%lf", &a) == 1) drive.driveDistance(a);
+    else if (std::sscanf(cmd, "point:%lf,%lf", &a, &b) == 2) motion.driveToPoint(a, b);
+    else if (std::sscanf(cmd, "pose:%lf,%lf,%lf", &a, &b, &c) == 3) motion.driveToPose(a, b, c);
+    else if (std::strncmp(cmd, "path:", 5) == 0) motion.followPath(parsePath(cmd + 5));
+    else if (std::strcmp(cmd, "spline") == 0) motion.followPath(SPLINE_PATH.view());
+    else if (std::sscanf(cmd, "async:%lf@%lf", &a, &b) == 2) {
+      MotionHandle h = motion.driveDistanceAsync(a);
+      h.waitUntilProgress(b);
+      h.cancel();
+      h.wait();
+    }
+    else if (std::sscanf(cmd, "async:%lf", &a) == 1) motion.driveDistanceAsync(a);
+    else if (std::strcmp(cmd, "tune") == 0) {
+      const autotune::Result r = autotune::run(drive);
+      if (r.ok) motion.setPoseGains(r.pose);
+      std::printf("tune %s: turn K %.5f tau %.3f L %.3f -> %.1f/%.1f/%.1f, "
+                  "drive K %.5f tau %.3f L %.3f -> %.1f/%.1f/%.1f, "
+                  "pose linear %.1f/%.1f angular %.0f/%.0f\n",
+                  r.ok ? "ok" : "FAILED",
+                  r.turnModel.gain, r.turnModel.tauSec, r.turnModel.deadSec, r.turn.kP, r.turn.kI, r.turn.kD,
+                  r.driveModel.gain, r.driveModel.tauSec, r.driveModel.deadSec,
+                  r.distance.kP, r.distance.kI, r.distance.kD,
+                  r.pose.linear.kP, r.pose.linear.kD, r.pose.angular.kP, r.pose.angular.kD);
+    }
+    else if (std::strcmp(cmd, "sysid") == 0) {
+      const sysid::Result r = sysid::run(drive);
+      std::printf("sysid %s: linear %.1f/%.2f/%.2f (r2 %.3f, n %d), angular %.1f/%.3f/%.3f (r2 %.3f, n %d)\n",
+                  r.ok ? "ok" : "FAILED",
+                  r.linear.model.kS, r.linear.model.kV, r.linear.model.kA, r.linear.r2, r.linear.samples,
+                  r.angular.model.kS, r.angular.model.kV, r.angular.model.kA, r.angular.r2, r.angular.samples);
+    }
+    else if (std::sscanf(cmd, "wait:%lf", &a) == 1) hal::delay((std::uint32_t)a);
+    else if (std::sscanf(cmd, "push:%lf", &a) == 1) model.setPushForce(a);
+    else if (std::sscanf(cmd, "hammer:%lf", &a) == 1) hammer(drive, thermal, model, a);
+    else if (std::sscanf(cmd, "unplug:%lf", &a) == 1) {
+      unplugUs = hal::micros() + (std::uint64_t)(std::max(a, 1.0) * 1000);
+      continue;
+    }
+    else if (std::strncmp(cmd, "record:", 7) == 0) recordDriver(drive, odom, cmd + 7);
+    else if (std::strncmp(cmd, "replay:", 7) == 0 || std::strncmp(cmd, "replay-open:", 12) == 0) {
+      const bool open = cmd[6] == '-';
+      recorder::ReplaySettings settings;
+      settings.correctDrift = !open;
+      if (!recorder::load(std::strchr(cmd, ':') + 1)) std::printf("can't load %s\n", std::strchr(cmd, ':') + 1);
+      else recorder::replay(drive, odom, settings);
+    }
+    else if (std::strncmp(cmd, "script:", 7) == 0) {
+      int route = 0;
+      while (route < script::routeCount() && std::strcmp(script::routeName(route), cmd + 7) != 0) route++;
+      if (route == script::routeCount()) std::printf("no route '%s'\n", cmd + 7);
+      else script::run(route, drive, motion, odom);
+    }
+    else {
+      std::printf("unknown command '%s'\n", cmd);
+      usage();
+      std::fflush(stdout);
+      std::_Exit(1);
+    }
+
+    report(cmd, startMs, odom, model);
+  }
+
+  const double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wallStart).count();
+  std::printf("sim %u ms in %.1f ms wall (%.0fx real time)\n",
+              hal::millis() - simStart, wallMs, (hal::millis() - simStart) / std::max(wallMs, 1e-3));
+  if (useTracking && odom.trackingLost()) std::printf("tracking wheels lost, odom fell back to motor encoders\n");
+  if (!useTracking || odom.trackingLost()) {
+    const Odom::SlipStats s = odom.slipStats();
+    std::printf("slip: %u events, %u ms\n", s.events, s.slipMs);
+  }
+  if (useMcl) {
+    const Mcl::Estimate e = loc.mcl.estimate();
+    const Mcl::Stats s = loc.mcl.stats();
+    const Odom::GpsStats g = odom.gpsStats();
+    std::printf("mcl (%.2f, %.2f, %.2f deg) spread %.2f in, %u updates, %u resamples; odom took %u fixes, rejected %u\n",
+                e.pose.x, e.pose.y, e.pose.theta * 180.0 / M_PI, e.spreadIn, s.updates, s.resamples,
+                g.accepted, g.rejected);
+  }
+  if (profile) profiler::dump();
+  std::fflush(stdout);
+
+  // Let the telemetry writer drain before exiting
+  if (logDir) hal::delay(200);
+
+  // Odom's task never returns; skip static teardown under it
+  std::_Exit(0);
+}
@@ -0,0 +1,39 @@
+#include "sim_distance_io.hpp"
+#include "config/constants.hpp"
+#include "localization/field_map.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace sim {
+
+namespace {
+  constexpr double M_TO_IN = 1.0 / 0.0254;
+  constexpr int MOUNTS = sizeof(constants::DISTANCE_MOUNTS) / sizeof(constants::DISTANCE_MOUNTS[0]);
+}
+
+SimDistanceIO::SimDistanceIO(const DiffDriveModel& model) : model(model) {}
+
+int SimDistanceIO::count() const {
+  return MOUNTS;
+}
+
+hal::DistanceIO::Reading SimDistanceIO::readIn(int i, double& out) {
+  if (i < 0 || i >= MOUNTS) return Reading::INVALID;
+
+  const constants::DistanceMount& m = constants::DISTANCE_MOUNTS[i];
+  const double x = model.xM() * M_TO_IN;
+  const double y = model.yM() * M_TO_IN;
+  const double t = model.thetaRad();
+  const double sx = x + m.xIn * std::cos(t) - m.yIn * std::sin(t);
+  const double sy = y + m.xIn * std::sin(t) + m.yIn * std::cos(t);
+
+  const double d = field::raycast(sx, sy, t + m.angleDeg * M_PI / 180.0);
+  if (d <= 0.0) return Reading::INVALID;
+  if (d > MAX_RANGE_IN) return Reading::NO_RETURN;
+
+  std::normal_distribution<double> noise(0.0, std::max(0.25, 0.01 * d));
+  out = d + noise(rng);
+  return Reading::HIT;
+}
+
+}
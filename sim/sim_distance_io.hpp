@@ -0,0 +1,20 @@
+#pragma once
+#include "hal/distance_io.hpp"
+#include "diff_drive_model.hpp"
+#include <random>
+
+namespace sim {
+  // Distance sensors at constants::DISTANCE_MOUNTS, raycast from the true
+  // pose against the field perimeter, with range limit and ~1% noise
+  class SimDistanceIO : public hal::DistanceIO {
+  public:
+    explicit SimDistanceIO(const DiffDriveModel& model);
+
+    int count() const override;
+    Reading readIn(int i, double& out) override;
+
+  private:
+    const DiffDriveModel& model;
+    std::mt19937 rng{4321};
+  };
+}
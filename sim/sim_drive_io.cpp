@@ -0,0 +1,58 @@
+#include "sim_drive_io.hpp"
+#include "hal/rtos.hpp"
+#include <cmath>
+
+namespace sim {
+
+SimDriveIO::SimDriveIO(DiffDriveModel& model) : model(model) {}
+
+void SimDriveIO::setVoltage(int leftMv, int rightMv) {
+  model.setVoltage(leftMv, rightMv);
+}
+
+void SimDriveIO::setBrakeHold(bool enabled) {
+  model.setBrakeHold(enabled);
+}
+
+void SimDriveIO::tare() {
+  leftTare = model.leftMotorDeg();
+  rightTare = model.rightMotorDeg();
+}
+
+hal::DriveSample SimDriveIO::sample() const {
+  const std::uint32_t now = hal::millis();
+  return hal::DriveSample{ model.leftMotorDeg() - leftTare, model.rightMotorDeg() - rightTare, now, now };
+}
+
+double SimDriveIO::headingDeg() const {
+  double deg = std::fmod((model.thetaRad() - imuZeroRad) * 180.0 / M_PI, 360.0);
+  if (deg < 0) deg += 360.0;
+  return deg;
+}
+
+double SimDriveIO::yawRateDps() const {
+  return model.yawRateRadS() * 180.0 / M_PI;
+}
+
+double SimDriveIO::forwardAccelG() const {
+  return model.accelMps2() / 9.81;
+}
+
+void SimDriveIO::calibrateImu() {
+  hal::delay(2000); // real IMU calibration time, costs nothing here
+  imuZeroRad = model.thetaRad();
+}
+
+hal::DrivePower SimDriveIO::power() const {
+  // Like the motors: whole 5 C steps, rounded down
+  auto reported = [](double c) { return 5.0 * std::floor(c / 5.0); };
+  return hal::DrivePower{reported(model.leftTempC()), reported(model.rightTempC()),
+                         model.leftCurrentA(), model.rightCurrentA(),
+                         model.throttled()};
+}
+
+double SimDriveIO::batteryMv() const {
+  return model.batteryVoltsNow() * 1000.0;
+}
+
+}
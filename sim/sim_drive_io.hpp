@@ -0,0 +1,31 @@
+#pragma once
+#include "hal/drive_io.hpp"
+#include "diff_drive_model.hpp"
+
+namespace sim {
+  // hal::DriveIO backed by the physics model instead of V5 smart devices
+  class SimDriveIO : public hal::DriveIO {
+  public:
+    explicit SimDriveIO(DiffDriveModel& model);
+
+    void setVoltage(int leftMv, int rightMv) override;
+    void setBrakeHold(bool enabled) override;
+    void tare() override;
+
+    hal::DriveSample sample() const override;
+    double headingDeg() const override;
+    double yawRateDps() const override;
+    double forwardAccelG() const override;
+
+    void calibrateImu() override;
+
+    hal::DrivePower power() const override;
+    double batteryMv() const override;
+
+  private:
+    DiffDriveModel& model;
+    double leftTare{0.0};
+    double rightTare{0.0};
+    double imuZeroRad{0.0};
+  };
+}
@@ -0,0 +1,43 @@
+#include "sim_gps_io.hpp"
+#include "config/constants.hpp"
+#include "hal/rtos.hpp"
+#include <cmath>
+
+namespace sim {
+
+namespace {
+  constexpr double M_TO_IN = 1.0 / 0.0254;
+}
+
+SimGpsIO::SimGpsIO(const DiffDriveModel& model, double errorIn) : model(model), errorIn(errorIn) {}
+
+void SimGpsIO::record(std::uint32_t nowMs) {
+  history[head] = Truth{nowMs, model.xM() * M_TO_IN, model.yM() * M_TO_IN, model.thetaRad()};
+  head = (head + 1) % HISTORY;
+  if (count < HISTORY) count++;
+}
+
+bool SimGpsIO::read(hal::GpsSample& out) const {
+  const std::uint32_t wantMs = hal::millis() - constants::GPS_LATENCY_MS;
+
+  // Newest recorded pose at or before the fix time
+  for (int k = 0; k < count; k++) {
+    const Truth& t = history[(head - 1 - k + HISTORY) % HISTORY];
+    if (t.timeMs > wantMs) continue;
+
+    std::normal_distribution<double> pos(0.0, errorIn);
+    std::normal_distribution<double> ang(0.0, 1.0);
+    double deg = std::fmod(t.thetaRad * 180.0 / M_PI + ang(rng), 360.0);
+    if (deg < 0) deg += 360.0;
+
+    out.xIn = t.xIn + pos(rng);
+    out.yIn = t.yIn + pos(rng);
+    out.headingDeg = deg;
+    out.errorIn = errorIn;
+    out.timeMs = t.timeMs;
+    return true;
+  }
+  return false;
+}
+
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include "hal/gps_io.hpp"
+#include "diff_drive_model.hpp"
+#include <cstdint>
+#include <random>
+
+namespace sim {
+  // GPS fixes from the true pose, delayed by GPS_LATENCY_MS and with
+  // Gaussian noise at the reported error. record() must run every physics
+  // step (from the step hook, hence the explicit time) so there's a delayed
+  // pose to hand out.
+  class SimGpsIO : public hal::GpsIO {
+  public:
+    explicit SimGpsIO(const DiffDriveModel& model, double errorIn = 0.5);
+
+    void record(std::uint32_t nowMs);
+    bool read(hal::GpsSample& out) const override;
+
+  private:
+    struct Truth {
+      std::uint32_t timeMs;
+      double xIn, yIn, thetaRad;
+    };
+    static constexpr int HISTORY = 256;  // ms
+
+    const DiffDriveModel& model;
+    double errorIn;
+    Truth history[HISTORY]{};
+    int head{0};
+    int count{0};
+    mutable std::mt19937 rng{1234};
+  };
+}
@@ -0,0 +1,110 @@
+#include "sim_runtime.hpp"
+#include "hal/rtos.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace {
+  std::mutex mtx;
+  std::condition_variable cv;
+
+  std::uint64_t nowUsVal = 0;
+  int running = 0;                            // tasks not parked in delay
+  std::multimap<std::uint64_t, bool*> wakers; // wake time -> "released" flag
+  std::function<void(double)> stepHook;
+
+  constexpr std::uint64_t STEP_US = 1000;
+
+  // Called with mtx held once the last running task parks.
+  void advanceLocked() {
+    while (running == 0 && !wakers.empty()) {
+      const std::uint64_t target = wakers.begin()->first;
+
+      while (nowUsVal < target) {
+        const std::uint64_t step = std::min(STEP_US, target - nowUsVal);
+        if (stepHook) stepHook(step / 1e6);
+        nowUsVal += step;
+      }
+
+      // Release everyone due now; they count as running from this point so a
+      // second advance can't slip in before they get the lock back.
+      auto it = wakers.begin();
+      while (it != wakers.end() && it->first <= nowUsVal) {
+        *it->second = true;
+        running++;
+        it = wakers.erase(it);
+      }
+    }
+    cv.notify_all();
+  }
+
+  void parkUntilLocked(std::unique_lock<std::mutex>& lk, std::uint64_t wakeUs) {
+    bool released = false;
+    wakers.emplace(wakeUs, &released);
+    running--;
+    if (running == 0) advanceLocked();
+    cv.wait(lk, [&] { return released; });
+  }
+}
+
+namespace sim {
+  void setStepHook(std::function<void(double)> hook) {
+    std::lock_guard<std::mutex> lk(mtx);
+    stepHook = std::move(hook);
+  }
+
+  void attachMainThread() {
+    std::lock_guard<std::mutex> lk(mtx);
+    running++;
+  }
+
+  std::uint64_t nowUs() {
+    std::lock_guard<std::mutex> lk(mtx);
+    return nowUsVal;
+  }
+}
+
+namespace hal {
+  std::uint32_t millis() {
+    return (std::uint32_t)(sim::nowUs() / 1000);
+  }
+
+  std::uint64_t micros() {
+    return sim::nowUs();
+  }
+
+  void delay(std::uint32_t ms) {
+    std::unique_lock<std::mutex> lk(mtx);
+    parkUntilLocked(lk, nowUsVal + (std::uint64_t)ms * 1000);
+  }
+
+  void delayUntil(std::uint32_t* prevMs, std::uint32_t periodMs) {
+    *prevMs += periodMs;
+    std::unique_lock<std::mutex> lk(mtx);
+    const std::uint64_t wakeUs = (std::uint64_t)*prevMs * 1000;
+    if (wakeUs <= nowUsVal) return;
+    parkUntilLocked(lk, wakeUs);
+  }
+
+  // Priority is meaningless in lockstep: tasks only interleave at delays
+  void startTask(std::function<void()> fn, const char*, std::uint32_t) {
+    {
+      std::lock_guard<std::mutex> lk(mtx);
+      running++;
+    }
+    std::thread([fn = std::move(fn)]() {
+      fn();
+      std::lock_guard<std::mutex> lk(mtx);
+      running--;
+      if (running == 0) advanceLocked();
+    }).detach();
+  }
+
+  std::uintptr_t currentTask() {
+    static std::atomic<std::uintptr_t> next{1};
+    thread_local const std::uintptr_t id = next++;
+    return id;
+  }
+}
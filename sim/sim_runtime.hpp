@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+
+// Lockstep virtual-time runtime behind hal:: for native builds.
+//
+// Every sim task is a real thread, but time only moves when *all* of them are
+// blocked in hal::delay. The clock then jumps straight to the next wake time,
+// calling the step hook once per simulated millisecond on the way. Control
+// code therefore sees exact 1 ms ticks and runs as fast as the CPU allows.
+namespace sim {
+  // Physics integration, called with dt in seconds while all tasks are parked
+  void setStepHook(std::function<void(double dtSec)> hook);
+
+  // Registers the calling thread (the scenario runner) as a sim task.
+  // Must be called once before any hal:: call from main().
+  void attachMainThread();
+
+  std::uint64_t nowUs();
+}
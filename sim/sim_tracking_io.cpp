@@ -0,0 +1,35 @@
+#include "sim_tracking_io.hpp"
+#include "config/constants.hpp"
+#include <cmath>
+
+namespace sim {
+
+namespace {
+  constexpr double M_TO_IN = 1.0 / 0.0254;
+
+  double inchesToSensorDeg(double inches) {
+    return inches / (constants::TRACKING_WHEEL_DIAMETER_IN * M_PI) * 360.0;
+  }
+}
+
+SimTrackingIO::SimTrackingIO(const DiffDriveModel& model, double scale) : model(model), scale(scale) {}
+
+// Body has no lateral velocity, so each wheel sees center travel plus its
+// lever arm times heading change (see Odom::stepTracking for the inverse).
+bool SimTrackingIO::read(hal::TrackingSample& out) const {
+  if (!unplugged.load()) {
+    const double travelIn = model.distanceM() * M_TO_IN;
+    const double headingRad = model.headingTravelRad();
+    last.leftDeg = scale * inchesToSensorDeg(travelIn + constants::TRACKING_LEFT_OFFSET_IN * headingRad);
+    last.rightDeg = scale * inchesToSensorDeg(travelIn - constants::TRACKING_RIGHT_OFFSET_IN * headingRad);
+    last.backDeg = scale * inchesToSensorDeg(-constants::TRACKING_BACK_OFFSET_IN * headingRad);
+  }
+  out = last;
+  return !unplugged.load();
+}
+
+void SimTrackingIO::unplug() {
+  unplugged.store(true);
+}
+
+}
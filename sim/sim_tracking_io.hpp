@@ -0,0 +1,25 @@
+#pragma once
+#include "hal/tracking_io.hpp"
+#include "diff_drive_model.hpp"
+#include <atomic>
+
+namespace sim {
+  // Ideal tracking wheels at the offsets in config/constants.hpp.
+  // They never slip, so they follow the body even when drive wheels spin.
+  class SimTrackingIO : public hal::TrackingIO {
+  public:
+    // scale != 1 models a mis-measured wheel diameter (odom drift)
+    explicit SimTrackingIO(const DiffDriveModel& model, double scale = 1.0);
+
+    bool read(hal::TrackingSample& out) const override;
+
+    // From now on every read fails, like a sensor cable pulled mid-match
+    void unplug();
+
+  private:
+    const DiffDriveModel& model;
+    double scale;
+    std::atomic<bool> unplugged{false};
+    mutable hal::TrackingSample last{0.0, 0.0, 0.0};
+  };
+}
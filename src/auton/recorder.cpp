@@ -0,0 +1,286 @@
+#include "auton/recorder.hpp"
+#include "control/command.hpp"
+#include "control/executive.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace recorder {
+
+namespace {
+  constexpr char MAGIC[4] = {'Z', 'R', 'P', 'L'};
+  constexpr std::uint16_t VERSION = 1;
+
+  constexpr int MV_PER_UNIT = 10;
+  constexpr std::uint8_t LEFT_CHANGED = 1 << 0;
+  constexpr std::uint8_t RIGHT_CHANGED = 1 << 1;
+  constexpr std::uint8_t MECH_CHANGED = 1 << 2;
+
+  // Flags, two 2-byte varints (|delta| <= 2400 units), mechanisms
+  constexpr int MAX_FRAME_BYTES = 6;
+  constexpr int STREAM_BYTES = MAX_FRAMES * MAX_FRAME_BYTES;
+  constexpr int MAX_POSE_KEYS = (MAX_FRAMES + POSE_EVERY - 1) / POSE_EVERY;
+  constexpr int MAX_UNITS = 12000 / MV_PER_UNIT;
+  constexpr int MAX_VARINT_BYTES = 2;
+  static_assert(2 * MAX_UNITS < (1 << 13), "voltage deltas must fit a 2-byte varint");
+
+  struct PoseKey {
+    float x, y, theta;
+  };
+
+  std::uint8_t stream[STREAM_BYTES];
+  int streamSize = 0;
+  PoseKey poses[MAX_POSE_KEYS];
+  PoseKey startPose{0, 0, 0};
+  int frameCount = 0;
+
+  // One owner of the buffer at a time: opcontrol while recording, the save
+  // task or auton while the SD card or replay has it
+  enum State { IDLE, RECORDING, BUSY };
+  std::atomic<State> state{IDLE};
+
+  bool claim(State to) {
+    State expected = IDLE;
+    return state.compare_exchange_strong(expected, to);
+  }
+
+  // Encoder state, so each frame only stores what changed
+  int lastLeft = 0;
+  int lastRight = 0;
+  std::uint8_t lastMech = 0;
+
+  void putVarint(int delta) {
+    std::uint32_t z = delta >= 0 ? (std::uint32_t)delta << 1 : ((std::uint32_t)(-delta) << 1) - 1;
+    while (z >= 0x80) {
+      stream[streamSize++] = (std::uint8_t)(z | 0x80);
+      z >>= 7;
+    }
+    stream[streamSize++] = (std::uint8_t)z;
+  }
+
+  // False if the varint runs past end or is longer than record() writes
+  bool getVarint(const std::uint8_t*& p, const std::uint8_t* end, int& out) {
+    std::uint32_t z = 0;
+    for (int i = 0; i < MAX_VARINT_BYTES; i++) {
+      if (p >= end) return false;
+      const std::uint8_t byte = *p++;
+      z |= (std::uint32_t)(byte & 0x7f) << (7 * i);
+      if (!(byte & 0x80)) {
+        out = (z & 1) ? -(int)((z + 1) >> 1) : (int)(z >> 1);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Applies one frame to the running values; false on anything record()
+  // couldn't have written
+  bool decodeFrame(const std::uint8_t*& p, const std::uint8_t* end, int& left, int& right, std::uint8_t& mech) {
+    if (p >= end) return false;
+    const std::uint8_t flags = *p++;
+    if (flags & ~(LEFT_CHANGED | RIGHT_CHANGED | MECH_CHANGED)) return false;
+
+    int delta;
+    if (flags & LEFT_CHANGED) {
+      if (!getVarint(p, end, delta)) return false;
+      left += delta;
+    }
+    if (flags & RIGHT_CHANGED) {
+      if (!getVarint(p, end, delta)) return false;
+      right += delta;
+    }
+    if (flags & MECH_CHANGED) {
+      if (p >= end) return false;
+      mech = *p++;
+    }
+    return std::abs(left) <= MAX_UNITS && std::abs(right) <= MAX_UNITS;
+  }
+
+  // The whole stream decodes to exactly frames frames
+  bool validStream(int frames, int bytes) {
+    const std::uint8_t* p = stream;
+    const std::uint8_t* const end = stream + bytes;
+    int left = 0, right = 0;
+    std::uint8_t mech = 0;
+    for (int i = 0; i < frames; i++) {
+      if (!decodeFrame(p, end, left, right, mech)) return false;
+    }
+    return p == end;
+  }
+
+  int toUnits(int mv) {
+    mv = std::clamp(mv, -12000, 12000);
+    return (mv >= 0 ? mv + MV_PER_UNIT / 2 : mv - MV_PER_UNIT / 2) / MV_PER_UNIT;
+  }
+
+  double wrapRad(double a) {
+    return std::remainder(a, 2.0 * M_PI);
+  }
+
+  // Recorded pose at frame i, between the keys around it
+  Pose poseAt(int i) {
+    const int k = i / POSE_EVERY;
+    const PoseKey& a = poses[k];
+    if ((k + 1) * POSE_EVERY >= frameCount) return Pose{a.x, a.y, a.theta};
+    const PoseKey& b = poses[k + 1];
+    const double t = (double)(i % POSE_EVERY) / POSE_EVERY;
+    return Pose{a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.theta + wrapRad(b.theta - a.theta) * t};
+  }
+
+  template <typename T>
+  bool writeAll(FILE* f, const T* data, std::size_t count) {
+    return std::fwrite(data, sizeof(T), count, f) == count;
+  }
+
+  template <typename T>
+  bool readAll(FILE* f, T* data, std::size_t count) {
+    return std::fread(data, sizeof(T), count, f) == count;
+  }
+}
+
+bool start(const Pose& pose) {
+  if (!claim(RECORDING)) return false;
+  streamSize = 0;
+  frameCount = 0;
+  lastLeft = 0;
+  lastRight = 0;
+  lastMech = 0;
+  startPose = PoseKey{(float)pose.x, (float)pose.y, (float)pose.theta};
+  return true;
+}
+
+bool record(int leftMv, int rightMv, std::uint8_t mechanisms, const Pose& pose) {
+  if (state.load() != RECORDING) return false;
+  if (frameCount >= MAX_FRAMES) {
+    stop();
+    return false;
+  }
+
+  const int left = toUnits(leftMv);
+  const int right = toUnits(rightMv);
+  const std::uint8_t flags = (left != lastLeft ? LEFT_CHANGED : 0) |
+                             (right != lastRight ? RIGHT_CHANGED : 0) |
+                             (mechanisms != lastMech ? MECH_CHANGED : 0);
+  stream[streamSize++] = flags;
+  if (flags & LEFT_CHANGED) putVarint(left - lastLeft);
+  if (flags & RIGHT_CHANGED) putVarint(right - lastRight);
+  if (flags & MECH_CHANGED) stream[streamSize++] = mechanisms;
+  lastLeft = left;
+  lastRight = right;
+  lastMech = mechanisms;
+
+  if (frameCount % POSE_EVERY == 0) poses[frameCount / POSE_EVERY] = PoseKey{(float)pose.x, (float)pose.y, (float)pose.theta};
+  frameCount++;
+  return true;
+}
+
+void stop() {
+  State expected = RECORDING;
+  state.compare_exchange_strong(expected, IDLE);
+}
+
+bool recording() {
+  return state.load() == RECORDING;
+}
+
+int frames() {
+  return frameCount;
+}
+
+bool save(const char* path) {
+  if (!claim(BUSY)) return false;
+  FILE* f = frameCount > 0 ? std::fopen(path, "wb") : nullptr;
+  if (!f) {
+    state.store(IDLE);
+    return false;
+  }
+
+  const std::uint16_t version = VERSION;
+  const std::uint16_t rateMs = RATE_MS;
+  const std::uint32_t frames = frameCount;
+  const std::uint32_t bytes = streamSize;
+  const int keys = (frameCount + POSE_EVERY - 1) / POSE_EVERY;
+  const bool ok = writeAll(f, MAGIC, 4) && writeAll(f, &version, 1) && writeAll(f, &rateMs, 1) &&
+                  writeAll(f, &frames, 1) && writeAll(f, &bytes, 1) && writeAll(f, &startPose, 1) &&
+                  writeAll(f, stream, streamSize) && writeAll(f, poses, keys);
+  const bool closed = std::fclose(f) == 0;
+  state.store(IDLE);
+  return closed && ok;
+}
+
+bool load(const char* path) {
+  if (!claim(BUSY)) return false;
+  FILE* f = std::fopen(path, "rb");
+  if (!f) {
+    state.store(IDLE);
+    return false;
+  }
+
+  char magic[4];
+  std::uint16_t version, rateMs;
+  std::uint32_t frames, bytes;
+  bool ok = readAll(f, magic, 4) && std::memcmp(magic, MAGIC, 4) == 0 &&
+            readAll(f, &version, 1) && version == VERSION &&
+            readAll(f, &rateMs, 1) && rateMs == RATE_MS &&
+            readAll(f, &frames, 1) && frames > 0 && frames <= (std::uint32_t)MAX_FRAMES &&
+            readAll(f, &bytes, 1) && bytes <= frames * MAX_FRAME_BYTES &&
+            readAll(f, &startPose, 1) && readAll(f, stream, bytes) &&
+            readAll(f, poses, (frames + POSE_EVERY - 1) / POSE_EVERY) &&
+            validStream((int)frames, (int)bytes);
+  std::fclose(f);
+
+  // Nothing half-loaded: replay() does nothing without frames
+  frameCount = ok ? (int)frames : 0;
+  streamSize = ok ? (int)bytes : 0;
+  state.store(IDLE);
+  return ok;
+}
+
+void replay(Drive& drive, Odom& odom, const ReplaySettings& settings) {
+  if (frameCount == 0 || !claim(BUSY)) return;
+  motion_command::claim();
+
+  odom.reset(Pose{startPose.x, startPose.y, startPose.theta});
+  drive.resetSlew();
+
+  FixedRate rate("replay", RATE_MS);
+  const std::uint8_t* p = stream;
+  const std::uint8_t* const end = stream + streamSize;
+  int left = 0, right = 0;
+  std::uint8_t mech = 0;
+  for (int i = 0; i < frameCount; i++) {
+    const std::uint8_t prevMech = mech;
+    if (!decodeFrame(p, end, left, right, mech)) break;
+    if (mech != prevMech && settings.mechanisms) settings.mechanisms(mech);
+
+    double leftMv = left * MV_PER_UNIT;
+    double rightMv = right * MV_PER_UNIT;
+    if (settings.correctDrift) {
+      // Error in the robot frame: along-track pushes both sides, heading
+      // (plus cross-track, steering the way we're driving) turns
+      const Pose want = poseAt(i);
+      const Pose now = odom.get();
+      const double dx = want.x - now.x, dy = want.y - now.y;
+      const double c = std::cos(now.theta), s = std::sin(now.theta);
+      const double along = dx * c + dy * s;
+      const double cross = -dx * s + dy * c;
+      const double direction = (left + right) < 0 ? -1.0 : 1.0;
+      const double steer = std::clamp(settings.crossRadPerIn * cross * direction, -0.5, 0.5);
+
+      const double lim = settings.maxCorrectionMv;
+      const double forward = std::clamp(settings.alongMvPerIn * along, -lim, lim);
+      const double turn = std::clamp(settings.headingMvPerRad * (wrapRad(want.theta - now.theta) + steer), -lim, lim);
+      leftMv += forward + turn;
+      rightMv += forward - turn;
+    }
+    drive.setVoltage((int)leftMv, (int)rightMv);
+    rate.wait();
+  }
+  drive.setVoltage(0, 0);
+  state.store(IDLE);
+}
+
+}
@@ -1,20 +1,42 @@
 #include "auton/routines.hpp"
+#include "auton/recorder.hpp"
+#include "auton/paths.hpp"
 #include "subsystems/devices.hpp"
+#include "drive/autotune.hpp"
+#include "drive/sysid.hpp"
+#include "motion/spline.hpp"
 #include "pros/rtos.hpp"
+#include "pros/llemu.hpp"
 
 namespace auton {
 
+  // Paths are baked at compile time in field coordinates (inches from field
+  // center). A path that clips a wall or turns tighter than the drive can
+  // follow fails the build, not the match.
+  namespace {
+    constexpr double ROBOT_HALF_IN = 9.0;      // center to bumper
+    constexpr double MIN_TURN_RADIUS_IN = 6.0;
+    constexpr double MAX_SPACING_IN = 2.0;     // well under the min lookahead
+
+    constexpr Pose SKILLS_START{-36.0, -36.0, 0.0};
+    constexpr auto SKILLS_PATH = paths::skills(SKILLS_START);
+
+    static_assert(spline::insideField(SKILLS_PATH, ROBOT_HALF_IN), "skills path leaves the field");
+    static_assert(spline::minRadius(SKILLS_PATH, MIN_TURN_RADIUS_IN), "skills path turns too tight");
+    static_assert(spline::maxSpacing(SKILLS_PATH, MAX_SPACING_IN), "skills path needs more samples");
+  }
+
   void doNothing() {
     // literally nothing
   }
 
   void skills() {
-    odom.reset(Pose{0, 0, 0});  // always reset at start of auto
-    motion.driveToPoint(24, 0);
-    pros::delay(200);
-    motion.driveToPoint(24, 24);
-    pros::delay(200);
-    motion.driveToPoint(0, 24);
+    odom.reset(SKILLS_START);  // always reset at start of auto
+    motion.followPath(SKILLS_PATH.view());
+  }
+
+  PathView skillsPath() {
+    return SKILLS_PATH.view();
   }
 
   void leftRush() {
@@ -28,4 +50,47 @@ namespace auton {
     pros::delay(150);
     drive.turnTo(-45); // if you want negatives, we’ll normalize later
   }
+
+  void tuneDrive() {
+    const autotune::Result r = autotune::run(drive);
+    if (!r.ok) {
+      pros::lcd::set_text(2, "Autotune failed");
+      master.print(2, 0, "Tune failed");
+      return;
+    }
+
+    motion.setPoseGains(r.pose);
+    const bool saved = autotune::save(drive, r.pose);
+    pros::lcd::print(2, "Tune %s T %.0f/%.0f/%.0f D %.0f/%.0f",
+                     saved ? "saved" : "NOT saved",
+                     r.turn.kP, r.turn.kI, r.turn.kD, r.distance.kP, r.distance.kD);
+    pros::lcd::print(3, "Pose L %.0f/%.0f A %.0f/%.0f",
+                     r.pose.linear.kP, r.pose.linear.kD, r.pose.angular.kP, r.pose.angular.kD);
+    master.print(2, 0, saved ? "Tune saved" : "Tune: no SD");
+  }
+
+  void characterize() {
+    const sysid::Result r = sysid::run(drive);
+    if (!r.ok) {
+      pros::lcd::set_text(2, "Sysid failed");
+      master.print(2, 0, "Sysid failed");
+      return;
+    }
+
+    const bool saved = sysid::save(drive);
+    pros::lcd::print(2, "Sysid %s L %.0f/%.1f/%.1f r2 %.2f",
+                     saved ? "saved" : "NOT saved",
+                     r.linear.model.kS, r.linear.model.kV, r.linear.model.kA, r.linear.r2);
+    pros::lcd::print(3, "A %.0f/%.2f/%.2f r2 %.2f",
+                     r.angular.model.kS, r.angular.model.kV, r.angular.model.kA, r.angular.r2);
+    master.print(2, 0, saved ? "Sysid saved" : "Sysid: no SD");
+  }
+
+  void replayDriver() {
+    if (recorder::frames() == 0) {
+      pros::lcd::set_text(2, "No driver recording");
+      return;
+    }
+    recorder::replay(drive, odom);
+  }
 }
@@ -0,0 +1,347 @@
+#include "auton/script.hpp"
+#include "hal/rtos.hpp"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace script {
+
+namespace {
+  enum class Op : std::uint8_t { END, RESET, DRIVE, TURN, POINT, POSE, PATH, WAIT, MECH };
+
+  struct Instr {
+    Op op;
+    std::uint8_t index;      // MECH: mechanism slot; PATH: points incl. the start slot
+    std::uint16_t pool;      // PATH: start slot in the point pool
+    float arg[3];
+  };
+  static_assert(sizeof(Instr) == 16, "keep instructions compact");
+
+  struct Command {
+    const char* name;
+    Op op;
+    int minArgs;
+    int maxArgs;
+  };
+
+  constexpr int MAX_PATH_OP_POINTS = 16;
+  constexpr Command COMMANDS[] = {
+    {"reset", Op::RESET, 3, 3},
+    {"drive", Op::DRIVE, 1, 1},
+    {"turn",  Op::TURN,  1, 1},
+    {"point", Op::POINT, 2, 2},
+    {"pose",  Op::POSE,  3, 3},
+    {"path",  Op::PATH,  2, 2 * MAX_PATH_OP_POINTS},
+    {"wait",  Op::WAIT,  1, 1},
+  };
+
+  // Anything beyond these is a typo, not a route
+  constexpr double MAX_COORD_IN = 144.0;
+  constexpr double MAX_WAIT_MS = 15000.0;
+  constexpr double MAX_MECH_VALUE = 1e6;
+
+  constexpr int LINE_LEN = 160;
+  constexpr int MAX_TOKENS = 2 + 2 * MAX_PATH_OP_POINTS;
+  constexpr int NAME_LEN = 24;
+
+  struct Route {
+    char name[NAME_LEN];
+    int start;
+  };
+
+  struct Mechanism {
+    char name[16];
+    void (*fn)(double);
+  };
+
+  Instr code[MAX_INSTRS];
+  int codeSize = 0;
+  Waypoint pool[MAX_PATH_POINTS];
+  double poolLen[MAX_PATH_POINTS];
+  int poolSize = 0;
+  Route routes[MAX_ROUTES];
+  int routesLoaded = 0;
+  Mechanism mechanisms[MAX_MECHANISMS];
+  int mechanismCount = 0;
+  char lastError[64] = "";
+
+  bool fail(int line, const char* msg, const char* detail = "") {
+    std::snprintf(lastError, sizeof(lastError), "line %d: %s%s", line, msg, detail);
+    return false;
+  }
+
+  bool parseNumber(const char* tok, double& out) {
+    char* end;
+    out = std::strtod(tok, &end);
+    return end != tok && *end == '\0' && std::isfinite(out);
+  }
+
+  const Command* findCommand(const char* name) {
+    for (const Command& c : COMMANDS) {
+      if (std::strcmp(c.name, name) == 0) return &c;
+    }
+    return nullptr;
+  }
+
+  int findMechanism(const char* name) {
+    for (int i = 0; i < mechanismCount; i++) {
+      if (std::strcmp(mechanisms[i].name, name) == 0) return i;
+    }
+    return -1;
+  }
+
+  // Splits in place on whitespace; a '#' ends the line
+  int tokenize(char* line, char* tokens[MAX_TOKENS + 1]) {
+    int n = 0;
+    char* p = line;
+    while (*p) {
+      while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') p++;
+      if (!*p || *p == '#') break;
+      if (n == MAX_TOKENS + 1) return n;   // caller reports too many
+      tokens[n++] = p;
+      while (*p && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n') p++;
+      if (*p) *p++ = '\0';
+    }
+    return n;
+  }
+
+  bool emit(int line, const Instr& in) {
+    if (codeSize >= MAX_INSTRS) return fail(line, "script too long");
+    code[codeSize++] = in;
+    return true;
+  }
+
+  bool endRoute(int line) {
+    if (routesLoaded == 0) return true;
+    if (codeSize == routes[routesLoaded - 1].start) return fail(line, "empty auton ", routes[routesLoaded - 1].name);
+    return emit(line, Instr{Op::END, 0, 0, {0, 0, 0}});
+  }
+
+  bool parseLine(int line, char* text) {
+    // The route name is the rest of the line, so handle it before tokenizing
+    while (*text == ' ' || *text == '\t') text++;
+    if (std::strncmp(text, "auton", 5) == 0 && (text[5] == ' ' || text[5] == '\t')) {
+      if (!endRoute(line)) return false;
+      if (routesLoaded >= MAX_ROUTES) return fail(line, "too many autons");
+
+      char* name = text + 6;
+      while (*name == ' ' || *name == '\t') name++;
+      char* end = name + std::strcspn(name, "#\r\n");
+      while (end > name && (end[-1] == ' ' || end[-1] == '\t')) end--;
+      *end = '\0';
+      if (!*name) return fail(line, "auton needs a name");
+
+      Route& r = routes[routesLoaded++];
+      std::snprintf(r.name, sizeof(r.name), "%s", name);
+      r.start = codeSize;
+      return true;
+    }
+
+    char* tok[MAX_TOKENS + 1];
+    const int n = tokenize(text, tok);
+    if (n == 0) return true;
+    if (routesLoaded == 0) return fail(line, "command before first 'auton': ", tok[0]);
+    if (n > MAX_TOKENS) return fail(line, "too many values");
+
+    double v[MAX_TOKENS];
+    for (int i = 1; i < n; i++) {
+      if (!parseNumber(tok[i], v[i - 1])) return fail(line, "not a number: ", tok[i]);
+    }
+    const int args = n - 1;
+
+    const int mech = findMechanism(tok[0]);
+    if (mech >= 0) {
+      if (args != 1) return fail(line, "mechanism takes one value: ", tok[0]);
+      if (std::abs(v[0]) > MAX_MECH_VALUE) return fail(line, "value out of range");
+      return emit(line, Instr{Op::MECH, (std::uint8_t)mech, 0, {(float)v[0], 0, 0}});
+    }
+
+    const Command* cmd = findCommand(tok[0]);
+    if (!cmd) return fail(line, "unknown command: ", tok[0]);
+    if (args < cmd->minArgs || args > cmd->maxArgs) return fail(line, "wrong number of values for ", cmd->name);
+
+    switch (cmd->op) {
+      case Op::WAIT:
+        if (v[0] < 0 || v[0] > MAX_WAIT_MS) return fail(line, "wait out of range");
+        break;
+      case Op::TURN:
+        break;
+      case Op::PATH:
+        if (args % 2 != 0) return fail(line, "path needs x y pairs");
+        [[fallthrough]];
+      default:
+        // Distances and coordinates; the heading of reset/pose is free
+        for (int i = 0; i < args; i++) {
+          const bool heading = (cmd->op == Op::RESET || cmd->op == Op::POSE) && i == 2;
+          if (!heading && std::abs(v[i]) > MAX_COORD_IN) return fail(line, "distance out of range");
+        }
+        break;
+    }
+
+    if (cmd->op == Op::PATH) {
+      const int points = args / 2 + 1;   // plus the start slot, filled in at run time
+      if (poolSize + points > MAX_PATH_POINTS) return fail(line, "too many path points");
+      const int first = poolSize;
+      pool[poolSize++] = Waypoint{0, 0};
+      for (int i = 0; i < args; i += 2) pool[poolSize++] = Waypoint{v[i], v[i + 1]};
+      return emit(line, Instr{Op::PATH, (std::uint8_t)points, (std::uint16_t)first, {0, 0, 0}});
+    }
+
+    Instr in{cmd->op, 0, 0, {0, 0, 0}};
+    for (int i = 0; i < args; i++) in.arg[i] = (float)v[i];
+    return emit(line, in);
+  }
+
+  double degToRad(double deg) {
+    return deg * M_PI / 180.0;
+  }
+}
+
+bool bindMechanism(const char* name, void (*fn)(double value)) {
+  if (mechanismCount >= MAX_MECHANISMS || !fn || findMechanism(name) >= 0 || findCommand(name)) return false;
+  std::snprintf(mechanisms[mechanismCount].name, sizeof(mechanisms[0].name), "%s", name);
+  mechanisms[mechanismCount].fn = fn;
+  mechanismCount++;
+  return true;
+}
+
+bool load(const char* path) {
+  codeSize = 0;
+  poolSize = 0;
+  routesLoaded = 0;
+  lastError[0] = '\0';
+
+  // No file is normal (no SD card, or no scripted routes): not an error
+  FILE* f = std::fopen(path, "r");
+  if (!f) return false;
+
+  char text[LINE_LEN];
+  int line = 0;
+  bool ok = true;
+  while (ok && std::fgets(text, sizeof(text), f)) {
+    line++;
+    if (!std::strchr(text, '\n') && !std::feof(f)) ok = fail(line, "line too long");
+    else ok = parseLine(line, text);
+  }
+  std::fclose(f);
+  if (ok) ok = endRoute(line);
+
+  // All or nothing: a half-loaded file is worse than none
+  if (!ok) routesLoaded = 0;
+  return ok && routesLoaded > 0;
+}
+
+const char* error() {
+  return lastError;
+}
+
+int routeCount() {
+  return routesLoaded;
+}
+
+const char* routeName(int route) {
+  return (route >= 0 && route < routesLoaded) ? routes[route].name : "";
+}
+
+int preview(int route, Waypoint* out, int max) {
+  if (route < 0 || route >= routesLoaded || max < 1) return 0;
+
+  Pose p{0, 0, 0};
+  int n = 0;
+  auto add = [&](double x, double y) {
+    if (n < max) out[n++] = Waypoint{x, y};
+  };
+  add(p.x, p.y);
+
+  for (const Instr* in = &code[routes[route].start]; in->op != Op::END; in++) {
+    switch (in->op) {
+      case Op::RESET:
+        p = Pose{in->arg[0], in->arg[1], degToRad(in->arg[2])};
+        if (n == 1) n = 0;   // a leading reset moves the start, not a leg
+        add(p.x, p.y);
+        break;
+      case Op::DRIVE:
+        p.x += in->arg[0] * std::cos(p.theta);
+        p.y += in->arg[0] * std::sin(p.theta);
+        add(p.x, p.y);
+        break;
+      case Op::TURN:
+        p.theta = degToRad(in->arg[0]);
+        break;
+      case Op::POINT:
+        if (in->arg[0] != p.x || in->arg[1] != p.y) p.theta = std::atan2(in->arg[1] - p.y, in->arg[0] - p.x);
+        p.x = in->arg[0];
+        p.y = in->arg[1];
+        add(p.x, p.y);
+        break;
+      case Op::POSE:
+        p = Pose{in->arg[0], in->arg[1], degToRad(in->arg[2])};
+        add(p.x, p.y);
+        break;
+      case Op::PATH: {
+        // Slot 0 is the run-time start, which is where the preview already is
+        const Waypoint* pts = &pool[in->pool];
+        for (int i = 1; i < in->index; i++) add(pts[i].x, pts[i].y);
+        const Waypoint a = in->index > 2 ? pts[in->index - 2] : Waypoint{p.x, p.y};
+        const Waypoint b = pts[in->index - 1];
+        if (a.x != b.x || a.y != b.y) p.theta = std::atan2(b.y - a.y, b.x - a.x);
+        p.x = b.x;
+        p.y = b.y;
+        break;
+      }
+      case Op::END:
+      case Op::WAIT:
+      case Op::MECH:
+        break;
+    }
+  }
+  return n;
+}
+
+void run(int route, Drive& drive, Motion& motion, Odom& odom) {
+  if (route < 0 || route >= routesLoaded) return;
+
+  for (const Instr* in = &code[routes[route].start];; in++) {
+    switch (in->op) {
+      case Op::END:
+        return;
+      case Op::RESET:
+        odom.reset(Pose{in->arg[0], in->arg[1], degToRad(in->arg[2])});
+        break;
+      case Op::DRIVE:
+        drive.driveDistance(in->arg[0]);
+        break;
+      case Op::TURN:
+        drive.turnTo(in->arg[0]);
+        break;
+      case Op::POINT:
+        motion.driveToPoint(in->arg[0], in->arg[1]);
+        break;
+      case Op::POSE:
+        motion.driveToPose(in->arg[0], in->arg[1], in->arg[2]);
+        break;
+      case Op::PATH: {
+        // Start from wherever the last command left us, like followPath()
+        Waypoint* pts = &pool[in->pool];
+        double* len = &poolLen[in->pool];
+        const Pose start = odom.get();
+        pts[0] = Waypoint{start.x, start.y};
+        len[0] = 0.0;
+        for (int i = 1; i < in->index; i++) {
+          len[i] = len[i - 1] + std::hypot(pts[i].x - pts[i - 1].x, pts[i].y - pts[i - 1].y);
+        }
+        motion.followPath(PathView{pts, len, nullptr, in->index, 0.0});
+        break;
+      }
+      case Op::WAIT:
+        hal::delay((std::uint32_t)in->arg[0]);
+        break;
+      case Op::MECH:
+        mechanisms[in->index].fn(in->arg[0]);
+        break;
+    }
+  }
+}
+
+}
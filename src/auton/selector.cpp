@@ -1,5 +1,6 @@
 #include "auton/selector.hpp"
 #include "auton/routines.hpp"
+#include "auton/script.hpp"
 #include "subsystems/devices.hpp"
 #include "pros/llemu.hpp"
 #include "pros/rtos.hpp"
@@ -11,18 +12,29 @@ namespace {
   struct AutonEntry {
     const char* name;
     void (*fn)();
+    PathView (*path)();   // preview, if the routine has fixed field coordinates
   };
 
   AutonEntry autos[] = {
-    {"Do Nothing", auton::doNothing},
-    {"Skills",     auton::skills},
-    {"Left Rush",  auton::leftRush},
-    {"Right Safe", auton::rightSafe},
+    {"Do Nothing", auton::doNothing,    nullptr},
+    {"Skills",     auton::skills,       auton::skillsPath},
+    {"Left Rush",  auton::leftRush,     nullptr},
+    {"Right Safe", auton::rightSafe,    nullptr},
+    {"Autotune",   auton::tuneDrive,    nullptr},
+    {"Sysid",      auton::characterize, nullptr},
+    {"Replay",     auton::replayDriver, nullptr},
   };
 
   constexpr int AUTO_COUNT = sizeof(autos) / sizeof(autos[0]);
-  std::atomic<int> index{0};
+
+  // Built-in routines first, then routes from the SD card script
+  int entryCount() {
+    return AUTO_COUNT + script::routeCount();
+  }
+
+  std::atomic<int> selected{0};
   std::atomic<bool> locked{false};
+  std::atomic<int> requested{-1};   // touchscreen pick, -1 when none
 
   bool risingEdge(bool current, bool& last) {
     bool pressed = current && !last;
@@ -37,6 +49,14 @@ namespace {
       bool L2 = master.get_digital(pros::E_CONTROLLER_DIGITAL_L2);
       bool X  = master.get_digital(pros::E_CONTROLLER_DIGITAL_X);
 
+      // Taps land here rather than in the LVGL callback, which mustn't block
+      // on the controller link
+      const int tapped = requested.exchange(-1);
+      if (tapped >= 0 && tapped < entryCount() && !locked.load() && tapped != selected.load()) {
+        selected.store(tapped);
+        auton_selector::display();
+      }
+
       if (risingEdge(X, lastX)) {
         locked.store(!locked.load());
         auton_selector::display();
@@ -44,15 +64,15 @@ namespace {
 
       if (!locked.load()) {
         if (risingEdge(L1, lastL1)) {
-          int i = index.load();
-          i = (i + 1) % AUTO_COUNT;
-          index.store(i);
+          int i = selected.load();
+          i = (i + 1) % entryCount();
+          selected.store(i);
           auton_selector::display();
         }
         if (risingEdge(L2, lastL2)) {
-          int i = index.load();
-          i = (i - 1 + AUTO_COUNT) % AUTO_COUNT;
-          index.store(i);
+          int i = selected.load();
+          i = (i - 1 + entryCount()) % entryCount();
+          selected.store(i);
           auton_selector::display();
         }
       } else {
@@ -74,23 +94,48 @@ void init() {
 }
 
 void next() {
-  int i = index.load();
-  i = (i + 1) % AUTO_COUNT;
-  index.store(i);
+  int i = selected.load();
+  i = (i + 1) % entryCount();
+  selected.store(i);
   display();
 }
 
 void prev() {
-  int i = index.load();
-  i = (i - 1 + AUTO_COUNT) % AUTO_COUNT;
-  index.store(i);
+  int i = selected.load();
+  i = (i - 1 + entryCount()) % entryCount();
+  selected.store(i);
   display();
 }
 
 const char* name() {
-  return autos[index.load()].name;
+  return nameAt(selected.load());
+}
+
+int count() { return entryCount(); }
+int selectedIndex() { return selected.load(); }
+
+const char* nameAt(int i) {
+  if (i < 0) return "";
+  return i < AUTO_COUNT ? autos[i].name : script::routeName(i - AUTO_COUNT);
 }
 
+int preview(int i, Waypoint* out, int max) {
+  if (i < 0 || i >= entryCount() || max < 2) return 0;
+  if (i >= AUTO_COUNT) return script::preview(i - AUTO_COUNT, out, max);
+  if (!autos[i].path) return 0;
+
+  // Baked paths are dense; keep an even spread of them, ends included
+  const PathView path = autos[i].path();
+  if (path.count <= max) {
+    for (int k = 0; k < path.count; k++) out[k] = path.pts[k];
+    return path.count;
+  }
+  for (int k = 0; k < max; k++) out[k] = path.pts[(long)k * (path.count - 1) / (max - 1)];
+  return max;
+}
+
+void request(int i) { requested.store(i); }
+
 void display() {
   master.clear();
   master.print(0, 0, "Auton:%s", locked.load() ? " LOCK" : "");
@@ -105,7 +150,9 @@ void setLocked(bool v) { locked.store(v); display(); }
 
 
 void run() {
-  autos[index.load()].fn();
+  const int i = selected.load();
+  if (i < AUTO_COUNT) autos[i].fn();
+  else script::run(i - AUTO_COUNT, drive, motion, odom);
 }
 
 }
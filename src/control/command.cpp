@@ -0,0 +1,87 @@
+#include "control/command.hpp"
+#include "hal/rtos.hpp"
+#include <algorithm>
+
+namespace {
+  // Only ever one async motion on the drivetrain. active is only read on
+  // activeTask, the task running it, so a loop on another task never
+  // reports into it or obeys its cancel.
+  std::shared_ptr<MotionCommand> current;
+  std::atomic<MotionCommand*> active{nullptr};
+  std::atomic<std::uintptr_t> activeTask{0};
+
+  constexpr std::uint32_t POLL_MS = 10;
+}
+
+bool MotionHandle::done() const {
+  return !cmd || cmd->done.load();
+}
+
+double MotionHandle::traveledIn() const {
+  return cmd ? cmd->traveledIn.load() : 0.0;
+}
+
+double MotionHandle::progress() const {
+  return cmd ? cmd->progress.load() : 1.0;
+}
+
+void MotionHandle::wait() const {
+  while (!done()) hal::delay(POLL_MS);
+}
+
+void MotionHandle::waitUntilDistance(double inches) const {
+  while (!done() && traveledIn() < inches) hal::delay(POLL_MS);
+}
+
+void MotionHandle::waitUntilProgress(double frac) const {
+  while (!done() && progress() < frac) hal::delay(POLL_MS);
+}
+
+void MotionHandle::cancel() const {
+  if (cmd) cmd->cancelRequested.store(true);
+}
+
+namespace motion_command {
+
+MotionHandle start(std::function<void()> fn) {
+  cancelAll();
+
+  auto cmd = std::make_shared<MotionCommand>();
+  current = cmd;
+
+  hal::startTask([cmd, fn = std::move(fn)]() {
+    active.store(cmd.get());
+    activeTask.store(hal::currentTask());
+    fn();
+    activeTask.store(0);
+    active.store(nullptr);
+    cmd->progress.store(std::max(cmd->progress.load(), cmd->cancelRequested.load() ? 0.0 : 1.0));
+    cmd->done.store(true);
+  }, "Motion");
+
+  return MotionHandle(cmd);
+}
+
+void cancelAll() {
+  if (!current) return;
+  MotionHandle previous(current);
+  previous.cancel();
+  previous.wait();
+  current.reset();
+}
+
+void claim() {
+  if (hal::currentTask() != activeTask.load()) cancelAll();
+}
+
+bool tick(double traveledIn, double progress) {
+  if (hal::currentTask() != activeTask.load()) return true;
+  MotionCommand* cmd = active.load();
+  if (!cmd) return true;
+
+  cmd->traveledIn.store(traveledIn);
+  cmd->progress.store(std::clamp(progress, 0.0, 1.0));
+  return !cmd->cancelRequested.load();
+}
+
+}
@@ -0,0 +1,104 @@
+#include "control/executive.hpp"
+#include "hal/rtos.hpp"
+#include "util/slot_table.hpp"
+#include <atomic>
+
+namespace {
+  // Written by the owning loop only, read by displays; relaxed is enough
+  struct Slot {
+    std::atomic<const char*> name{nullptr};
+    std::atomic<std::uint32_t> periodMs{0};
+    std::atomic<std::uint32_t> ticks{0};
+    std::atomic<std::uint32_t> overruns{0};
+    std::atomic<std::uint32_t> lastDtUs{0};
+    std::atomic<std::uint64_t> sumJitterUs{0};
+    std::atomic<std::uint32_t> maxJitterUs{0};
+  };
+
+  Slot slots[executive::MAX_LOOPS];
+
+  int claimLoopSlot(const char* name) {
+    return claimNamedSlot(executive::MAX_LOOPS, name, [](int i) -> std::atomic<const char*>& { return slots[i].name; });
+  }
+}
+
+FixedRate::FixedRate(const char* name, std::uint32_t periodMs)
+  : slot(claimLoopSlot(name)), busy(name, periodMs * 1000), periodMs(periodMs) {
+  firstMs = prevMs = hal::millis();
+  lastUs = hal::micros();
+  if (slot >= 0) slots[slot].periodMs.store(periodMs, std::memory_order_relaxed);
+}
+
+std::uint32_t FixedRate::elapsedMs() const {
+  return hal::millis() - firstMs;
+}
+
+double FixedRate::wait() {
+  // lastUs is when the previous wait() returned, so this is the loop body
+  busy.record((std::uint32_t)(hal::micros() - lastUs));
+
+  // Deadline already passed => overrun. If we're more than a whole period
+  // behind, drop the missed ticks instead of letting delay_until fire a
+  // burst of back-to-back iterations.
+  const std::uint32_t late = hal::millis() - prevMs;
+  const bool overrun = late >= periodMs;
+  if (late >= 2 * periodMs) prevMs += late - periodMs;
+
+  hal::delayUntil(&prevMs, periodMs);
+
+  const std::uint64_t nowUs = hal::micros();
+  const std::uint32_t dtUs = (std::uint32_t)(nowUs - lastUs);
+  lastUs = nowUs;
+
+  if (slot >= 0) {
+    Slot& s = slots[slot];
+    const std::uint32_t periodUs = periodMs * 1000;
+    const std::uint32_t jitterUs = dtUs > periodUs ? dtUs - periodUs : periodUs - dtUs;
+
+    s.ticks.fetch_add(1, std::memory_order_relaxed);
+    if (overrun) s.overruns.fetch_add(1, std::memory_order_relaxed);
+    s.lastDtUs.store(dtUs, std::memory_order_relaxed);
+    s.sumJitterUs.fetch_add(jitterUs, std::memory_order_relaxed);
+    if (jitterUs > s.maxJitterUs.load(std::memory_order_relaxed))
+      s.maxJitterUs.store(jitterUs, std::memory_order_relaxed);
+  }
+
+  return dtUs / 1e6;
+}
+
+namespace executive {
+
+int count() {
+  int n = 0;
+  for (const auto& s : slots) if (s.name.load()) n++;
+  return n;
+}
+
+bool stats(int i, LoopStats& out) {
+  if (i < 0 || i >= MAX_LOOPS) return false;
+  const Slot& s = slots[i];
+  const char* name = s.name.load();
+  if (!name) return false;
+
+  const std::uint32_t ticks = s.ticks.load(std::memory_order_relaxed);
+  out.name = name;
+  out.periodMs = s.periodMs.load(std::memory_order_relaxed);
+  out.ticks = ticks;
+  out.overruns = s.overruns.load(std::memory_order_relaxed);
+  out.lastDtMs = s.lastDtUs.load(std::memory_order_relaxed) / 1000.0;
+  out.meanJitterMs = ticks ? s.sumJitterUs.load(std::memory_order_relaxed) / 1000.0 / ticks : 0.0;
+  out.maxJitterMs = s.maxJitterUs.load(std::memory_order_relaxed) / 1000.0;
+  return true;
+}
+
+void resetStats() {
+  for (auto& s : slots) {
+    s.ticks.store(0);
+    s.overruns.store(0);
+    s.lastDtUs.store(0);
+    s.sumJitterUs.store(0);
+    s.maxJitterUs.store(0);
+  }
+}
+
+}
@@ -0,0 +1,110 @@
+#include "control/motion_profile.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+  // Accel-phase timing for a jerk-limited ramp from rest to v.
+  // Returns total ramp time, writes the jerk-phase time.
+  double rampTime(double v, double amax, double jmax, double& tj) {
+    if (jmax <= 0) {
+      tj = 0.0;
+      return v / amax;
+    }
+    if (v * jmax >= amax * amax) {
+      tj = amax / jmax;
+      return tj + v / amax;
+    }
+    tj = std::sqrt(v / jmax);  // amax never reached
+    return 2.0 * tj;
+  }
+}
+
+MotionProfile::MotionProfile(double distance, const ProfileConstraints& limits) {
+  sign = distance < 0 ? -1.0 : 1.0;
+  build(std::abs(distance), limits);
+}
+
+void MotionProfile::build(double dist, const ProfileConstraints& limits) {
+  const double amax = std::abs(limits.maxAccel);
+  const double jmax = std::abs(limits.maxJerk);
+  double vmax = std::abs(limits.maxVel);
+
+  if (dist <= 0 || vmax <= 0 || amax <= 0) {
+    segs[0] = Segment{0, 0, 0, 0, 0};
+    count = 1;
+    total = 0.0;
+    return;
+  }
+
+  // A symmetric rest-to-rest ramp covers v * ramp / 2 each way, so the two
+  // ramps together cover v * ramp. If that's more than we have, find the
+  // peak velocity that exactly fits (ramp grows with v, so bisect).
+  double tj;
+  double ta = rampTime(vmax, amax, jmax, tj);
+  if (vmax * ta > dist) {
+    double lo = 0.0, hi = vmax;
+    for (int i = 0; i < 50; i++) {
+      const double mid = (lo + hi) / 2.0;
+      double tjm;
+      if (mid * rampTime(mid, amax, jmax, tjm) > dist) hi = mid;
+      else lo = mid;
+    }
+    vmax = lo;
+    ta = rampTime(vmax, amax, jmax, tj);
+  }
+  const double tv = std::max(0.0, (dist - vmax * ta) / vmax);
+
+  // Jerk per segment and durations: ramp up, cruise, ramp down
+  const double peakA = (jmax > 0) ? std::min(amax, jmax * tj) : amax;
+  double durations[7];
+  double jerks[7];
+  double accels[7];  // only used by the trapezoid (infinite jerk)
+  if (jmax > 0) {
+    const double tc = ta - 2.0 * tj;
+    const double d[7] = { tj, tc, tj, tv, tj, tc, tj };
+    const double j[7] = { jmax, 0, -jmax, 0, -jmax, 0, jmax };
+    std::copy(d, d + 7, durations);
+    std::copy(j, j + 7, jerks);
+    count = 7;
+  } else {
+    const double d[3] = { ta, tv, ta };
+    const double a[3] = { peakA, 0.0, -peakA };
+    std::copy(d, d + 3, durations);
+    std::copy(a, a + 3, accels);
+    std::fill(jerks, jerks + 3, 0.0);
+    count = 3;
+  }
+
+  double t = 0, p = 0, v = 0, a = 0;
+  for (int i = 0; i < count; i++) {
+    if (jmax <= 0) a = accels[i];
+    segs[i] = Segment{ t, p, v, a, jerks[i] };
+
+    const double dt = durations[i];
+    const double jk = jerks[i];
+    p += v * dt + a * dt * dt / 2.0 + jk * dt * dt * dt / 6.0;
+    v += a * dt + jk * dt * dt / 2.0;
+    a += jk * dt;
+    t += dt;
+  }
+  total = t;
+}
+
+ProfileState MotionProfile::sample(double t) const {
+  t = std::clamp(t, 0.0, total);
+
+  int i = count - 1;
+  while (i > 0 && segs[i].t0 > t) i--;
+  const Segment& s = segs[i];
+
+  const double dt = t - s.t0;
+  double p = s.p0 + s.v0 * dt + s.a0 * dt * dt / 2.0 + s.jerk * dt * dt * dt / 6.0;
+  double v = s.v0 + s.a0 * dt + s.jerk * dt * dt / 2.0;
+  double a = s.a0 + s.jerk * dt;
+
+  if (t >= total) {
+    v = 0.0;
+    a = 0.0;
+  }
+  return ProfileState{ sign * p, sign * v, sign * a };
+}
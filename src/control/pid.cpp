@@ -1,11 +1,12 @@
 #include "control/pid.hpp"
 #include <cmath>
 
-PID::PID(double kP, double kI, double kD) : kP(kP), kI(kI), kD(kD) {}
+PID::PID(double kP, double kI, double kD) : base{kP, kI, kD} {}
 
 void PID::reset() {
-  integral = 0.0;
-  lastError = 0.0;
+  iTerm = 0.0;
+  lastCurrent = 0.0;
+  dFiltered = 0.0;
   firstStep = true;
 }
 
@@ -17,20 +18,79 @@ void PID::setIntegralLimit(double maxAbs) {
   iLimit = std::abs(maxAbs);
 }
 
+void PID::setIntegralBand(double maxAbsError) {
+  iBand = std::abs(maxAbsError);
+}
+
+void PID::setDerivativeFilter(double tauSec) {
+  dTau = std::max(0.0, tauSec);
+}
+
+void PID::setAntiWindup(double gainPerSec) {
+  awGain = gainPerSec;
+}
+
+void PID::setGainSchedule(const GainPoint* points, int count) {
+  scheduleLen = std::clamp(count, 0, MAX_SCHEDULE);
+  for (int i = 0; i < scheduleLen; i++) schedule[i] = points[i];
+}
+
+void PID::setLog(telemetry::Channel* channel) {
+  log = channel;
+}
+
+PID::Gains PID::gainsAt(double errorAbs) const {
+  if (scheduleLen == 0) return base;
+  if (errorAbs <= schedule[0].errorAbs) return schedule[0].gains;
+
+  for (int i = 1; i < scheduleLen; i++) {
+    const GainPoint& hi = schedule[i];
+    if (errorAbs > hi.errorAbs) continue;
+
+    const GainPoint& lo = schedule[i - 1];
+    const double span = hi.errorAbs - lo.errorAbs;
+    const double t = span > 0 ? (errorAbs - lo.errorAbs) / span : 1.0;
+    return Gains{
+      lo.gains.kP + t * (hi.gains.kP - lo.gains.kP),
+      lo.gains.kI + t * (hi.gains.kI - lo.gains.kI),
+      lo.gains.kD + t * (hi.gains.kD - lo.gains.kD),
+    };
+  }
+  return schedule[scheduleLen - 1].gains;
+}
+
 double PID::step(double target, double current, double dt) {
   if (dt <= 0) return 0;
 
   const double error = target - current;
+  const Gains g = gainsAt(std::abs(error));
 
-  integral += error * dt;
-  integral = std::clamp(integral, -iLimit, iLimit);
-
-  double derivative = 0.0;
-  if (!firstStep) derivative = (error - lastError) / dt;
+  // Derivative of -measurement == derivative of error while target holds,
+  // without the spike when it moves
+  double dRaw = 0.0;
+  if (!firstStep) dRaw = -(current - lastCurrent) / dt;
+  lastCurrent = current;
 
-  lastError = error;
+  if (firstStep || dTau <= 0) {
+    dFiltered = dRaw;
+  } else {
+    const double alpha = dTau / (dTau + dt);
+    dFiltered = alpha * dFiltered + (1.0 - alpha) * dRaw;
+  }
   firstStep = false;
 
-  const double output = (kP * error) + (kI * integral) + (kD * derivative);
-  return std::clamp(output, -outLimit, outLimit);
+  const double pOut = g.kP * error;
+  const double dOut = g.kD * dFiltered;
+  const double raw = pOut + iTerm + dOut;
+  const double output = std::clamp(raw, -outLimit, outLimit);
+
+  // Integrate after computing output; back-calculation pulls I back by
+  // however much the output was clipped
+  if (std::abs(error) < iBand) iTerm += g.kI * error * dt;
+  const double kAw = awGain >= 0 ? awGain : (g.kP > 0 ? g.kI / g.kP : 0.0);
+  iTerm += kAw * (output - raw) * dt;
+  iTerm = std::clamp(iTerm, -iLimit, iLimit);
+
+  if (log) log->log(target, current, output, pOut, iTerm, dOut);
+  return output;
 }
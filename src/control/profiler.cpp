@@ -0,0 +1,108 @@
+#include "control/profiler.hpp"
+#include "hal/rtos.hpp"
+#include "util/slot_table.hpp"
+#include <atomic>
+#include <cstdio>
+
+namespace {
+  // Written by the owning loop, read by display/dump; relaxed is enough
+  struct Stats {
+    std::atomic<const char*> name{nullptr};
+    std::atomic<std::uint32_t> budgetUs{0};
+    std::atomic<std::uint32_t> count{0};
+    std::atomic<std::uint32_t> overruns{0};
+    std::atomic<std::uint64_t> sumUs{0};
+    std::atomic<std::uint32_t> minUs{UINT32_MAX};
+    std::atomic<std::uint32_t> maxUs{0};
+    std::atomic<std::uint32_t> bins[profiler::BINS + 1];
+  };
+
+  Stats stats[profiler::MAX_SECTIONS];
+
+  int claimSectionSlot(const char* name) {
+    return claimNamedSlot(profiler::MAX_SECTIONS, name, [](int i) -> std::atomic<const char*>& { return stats[i].name; });
+  }
+}
+
+namespace profiler {
+
+Section::Section(const char* name, std::uint32_t budgetUs) : slot(claimSectionSlot(name)) {
+  if (slot >= 0 && budgetUs) stats[slot].budgetUs.store(budgetUs, std::memory_order_relaxed);
+}
+
+void Section::record(std::uint32_t us) const {
+  if (slot < 0) return;
+  Stats& s = stats[slot];
+
+  s.count.fetch_add(1, std::memory_order_relaxed);
+  s.sumUs.fetch_add(us, std::memory_order_relaxed);
+  if (us < s.minUs.load(std::memory_order_relaxed)) s.minUs.store(us, std::memory_order_relaxed);
+  if (us > s.maxUs.load(std::memory_order_relaxed)) s.maxUs.store(us, std::memory_order_relaxed);
+
+  const std::uint32_t budget = s.budgetUs.load(std::memory_order_relaxed);
+  if (budget && us > budget) s.overruns.fetch_add(1, std::memory_order_relaxed);
+
+  const std::uint32_t bin = us / BIN_US;
+  s.bins[bin < BINS ? bin : BINS].fetch_add(1, std::memory_order_relaxed);
+}
+
+bool summary(int i, Summary& out) {
+  if (i < 0 || i >= MAX_SECTIONS) return false;
+  const Stats& s = stats[i];
+  const char* name = s.name.load();
+  if (!name) return false;
+
+  const std::uint32_t count = s.count.load(std::memory_order_relaxed);
+  out.name = name;
+  out.count = count;
+  out.overruns = s.overruns.load(std::memory_order_relaxed);
+  out.budgetUs = s.budgetUs.load(std::memory_order_relaxed);
+  out.minUs = count ? s.minUs.load(std::memory_order_relaxed) : 0.0;
+  out.maxUs = s.maxUs.load(std::memory_order_relaxed);
+  out.meanUs = count ? (double)s.sumUs.load(std::memory_order_relaxed) / count : 0.0;
+
+  // First bin where the running total reaches 99%
+  out.p99Us = out.maxUs;
+  const std::uint32_t target = count - count / 100;
+  std::uint32_t running = 0;
+  for (int b = 0; b < BINS && count; b++) {
+    running += s.bins[b].load(std::memory_order_relaxed);
+    if (running >= target) {
+      out.p99Us = (double)(b + 1) * BIN_US;
+      if (out.p99Us > out.maxUs) out.p99Us = out.maxUs;
+      break;
+    }
+  }
+  return true;
+}
+
+void reset() {
+  for (auto& s : stats) {
+    s.count.store(0);
+    s.overruns.store(0);
+    s.sumUs.store(0);
+    s.minUs.store(UINT32_MAX);
+    s.maxUs.store(0);
+    for (auto& b : s.bins) b.store(0);
+  }
+}
+
+void dump() {
+  std::printf("%-16s %8s %6s %8s %8s %8s %8s %8s\n",
+              "section", "count", "over", "budget", "min", "mean", "p99", "max");
+  for (int i = 0; i < MAX_SECTIONS; i++) {
+    Summary s;
+    if (!summary(i, s)) continue;
+    std::printf("%-16s %8u %6u %8u %8.0f %8.1f %8.0f %8.0f\n",
+                s.name, s.count, s.overruns, s.budgetUs, s.minUs, s.meanUs, s.p99Us, s.maxUs);
+  }
+}
+
+}
+
+ProfileScope::ProfileScope(const profiler::Section& section)
+  : section(section), startUs(hal::micros()) {}
+
+ProfileScope::~ProfileScope() {
+  section.record((std::uint32_t)(hal::micros() - startUs));
+}
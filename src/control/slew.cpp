@@ -11,6 +11,10 @@ void Slew::reset(double v) {
   value = v;
 }
 
+void Slew::setLog(telemetry::Channel* channel) {
+  log = channel;
+}
+
 double Slew::step(double target, double dt) {
   if (dt <= 0) return value;
 
@@ -21,5 +25,6 @@ double Slew::step(double target, double dt) {
   else if (delta < -maxDelta) value -= maxDelta;
   else value = target;
 
+  if (log) log->log(target, value);
   return value;
 }
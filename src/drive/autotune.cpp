@@ -0,0 +1,168 @@
+#include "drive/autotune.hpp"
+#include "config/constants.hpp"
+#include "control/command.hpp"
+#include "control/executive.hpp"
+#include "hal/rtos.hpp"
+#include "util/units.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+  constexpr int MAX_SAMPLES = 200;  // 2 s at 10 ms
+
+  // Rate samples from one step test
+  struct StepLog {
+    double rate[MAX_SAMPLES];
+    int n{0};
+  };
+
+  double avgInches(const hal::DriveSample& s) {
+    return (constants::motorDegToInches(s.leftDeg) + constants::motorDegToInches(s.rightDeg)) / 2.0;
+  }
+
+  // Open-loop voltage step, turning in place or straight; records heading
+  // rate (deg/s) or forward speed (in/s) every 10 ms
+  void stepTest(Drive& drive, bool turn, const autotune::Settings& cfg, StepLog& out) {
+    drive.enableSlew(false);
+
+    const int mv = (int)cfg.stepMv;
+    drive.setVoltage(mv, turn ? -mv : mv);
+
+    FixedRate rate("autotune", 10);
+    double lastHeading = drive.headingDeg();
+    double lastIn = avgInches(drive.sample());
+    double dt = rate.wait();
+
+    out.n = 0;
+    while (rate.elapsedMs() < cfg.stepMs && out.n < MAX_SAMPLES) {
+      if (turn) {
+        const double heading = drive.headingDeg();
+        out.rate[out.n++] = -angleErrorDeg(lastHeading, heading) / dt;
+        lastHeading = heading;
+      } else {
+        const double in = avgInches(drive.sample());
+        out.rate[out.n++] = (in - lastIn) / dt;
+        lastIn = in;
+      }
+      dt = rate.wait();
+    }
+
+    drive.setVoltage(0, 0);
+    drive.enableSlew(true);
+    drive.resetSlew();
+  }
+
+  // Two-point FOPDT fit: steady state from the last quarter, dead time at
+  // 5% of it, time constant from there to 63%
+  bool fit(const StepLog& log, double stepMv, double periodSec, autotune::Model& out) {
+    if (log.n < 8) return false;
+
+    const int tail = std::max(2, log.n / 4);
+    double ss = 0.0;
+    for (int i = log.n - tail; i < log.n; i++) ss += log.rate[i];
+    ss /= tail;
+    if (ss <= 0) return false;
+
+    int i5 = -1, i63 = -1;
+    for (int i = 0; i < log.n; i++) {
+      if (i5 < 0 && log.rate[i] >= 0.05 * ss) i5 = i;
+      if (i63 < 0 && log.rate[i] >= 0.63 * ss) { i63 = i; break; }
+    }
+    if (i5 < 0 || i63 < 0) return false;
+
+    // Sample i covers ((i), (i+1)] periods after the step
+    out.gain = ss / stepMv;
+    out.deadSec = i5 * periodSec;
+    out.tauSec = std::max(periodSec, (i63 + 1 - i5) * periodSec);
+    return true;
+  }
+}
+
+namespace autotune {
+
+PID::Gains design(const Model& model, double settleSec, bool withIntegral) {
+  // Position plant K/(s(tau*s+1)) under PD: tau*s^2 + (1 + K*kD)*s + K*kP.
+  // zeta = 1 settles to 2% in ~5.8/wn; dead time caps the usable wn.
+  const double K = model.gain;
+  const double tau = model.tauSec;
+  double wn = 5.8 / std::max(settleSec, 0.05);
+  wn = std::min(wn, 0.5 / std::max(model.deadSec, 0.01));
+
+  PID::Gains g;
+  g.kP = tau * wn * wn / K;
+  g.kD = std::max(0.0, (2.0 * wn * tau - 1.0) / K);
+  g.kI = withIntegral ? g.kP * wn / 5.0 : 0.0;
+  return g;
+}
+
+Result run(Drive& drive, const Settings& cfg) {
+  motion_command::claim();
+  Result r{};
+  StepLog log;
+  const double period = 0.01;
+
+  // Turn in place, then back to where we started
+  const double startHeading = drive.headingDeg();
+  stepTest(drive, true, cfg, log);
+  const bool turnOk = fit(log, cfg.stepMv, period, r.turnModel);
+  hal::delay(300);
+  drive.turnTo(startHeading);
+
+  // Straight, then back
+  const double startIn = avgInches(drive.sample());
+  stepTest(drive, false, cfg, log);
+  const bool driveOk = fit(log, cfg.stepMv, period, r.driveModel);
+  hal::delay(300);
+  const double traveled = avgInches(drive.sample()) - startIn;
+  drive.driveDistance(-traveled, startHeading);
+
+  r.ok = turnOk && driveOk;
+  if (!r.ok) return r;
+
+  r.turn = design(r.turnModel, cfg.turnSettleSec, true);
+  r.distance = design(r.driveModel, cfg.driveSettleSec, false);
+  drive.setTurnGains(r.turn);
+  drive.setDistanceGains(r.distance);
+
+  // The turn model is in degrees; driveToPose steers in radians
+  const double perRad = 180.0 / M_PI;
+  r.pose.linear = design(r.driveModel, cfg.poseLinearSettleSec, false);
+  r.pose.angular = design(r.turnModel, cfg.poseAngularSettleSec, false);
+  r.pose.angular.kP *= perRad;
+  r.pose.angular.kD *= perRad;
+  return r;
+}
+
+bool save(const Drive& drive, const PoseGains& pose, const char* path) {
+  FILE* f = std::fopen(path, "w");
+  if (!f) return false;
+  const PID::Gains t = drive.turnGains();
+  const PID::Gains d = drive.distanceGains();
+  std::fprintf(f, "turn %.4f %.4f %.4f\n", t.kP, t.kI, t.kD);
+  std::fprintf(f, "distance %.4f %.4f %.4f\n", d.kP, d.kI, d.kD);
+  std::fprintf(f, "poseLinear %.4f %.4f %.4f\n", pose.linear.kP, pose.linear.kI, pose.linear.kD);
+  std::fprintf(f, "poseAngular %.4f %.4f %.4f\n", pose.angular.kP, pose.angular.kI, pose.angular.kD);
+  std::fclose(f);
+  return true;
+}
+
+bool load(Drive& drive, PoseGains& pose, const char* path) {
+  FILE* f = std::fopen(path, "r");
+  if (!f) return false;
+
+  char key[16];
+  PID::Gains g;
+  int found = 0;
+  while (std::fscanf(f, "%15s %lf %lf %lf", key, &g.kP, &g.kI, &g.kD) == 4) {
+    if (std::strcmp(key, "turn") == 0) { drive.setTurnGains(g); found++; }
+    else if (std::strcmp(key, "distance") == 0) { drive.setDistanceGains(g); found++; }
+    else if (std::strcmp(key, "poseLinear") == 0) { pose.linear = g; found++; }
+    else if (std::strcmp(key, "poseAngular") == 0) { pose.angular = g; found++; }
+  }
+  std::fclose(f);
+  return found > 0;
+}
+
+}
@@ -1,46 +1,31 @@
 #include "drive/drive.hpp"
 #include "config/constants.hpp"
-#include "pros/rtos.hpp"
+#include "hal/rtos.hpp"
+#include "control/executive.hpp"
+#include "control/command.hpp"
 #include <cmath>
 #include "util/units.hpp"
+#include "telemetry/telemetry.hpp"
 
-
-static double avgMotorPositionDeg(const std::array<pros::Motor, 3>& motors) {
-  double sum = 0.0;
-  for (const auto& m : motors) sum += m.get_position(); // degrees
-  return sum / 3.0;
+namespace {
+  telemetry::Channel turnLog("turnTo", "target,current,out,p,i,d");
+  telemetry::Channel distLog("driveDistance", "target,current,out,p,i,d");
+  telemetry::Channel leftSlewLog("slewLeft", "target,out");
+  telemetry::Channel rightSlewLog("slewRight", "target,out");
 }
 
-Drive::Drive(int l1, int l2, int l3, int r1, int r2, int r3, int imuPort)
-  : left{ pros::Motor(l1), pros::Motor(l2), pros::Motor(l3) }
-  , right{ pros::Motor(r1), pros::Motor(r2), pros::Motor(r3) }
-  , imu(imuPort) {
-
-  // Common convention:
-  // Left motors forward = +, Right motors forward = +.
-  // If your right side drives backward, flip these true/false later.
-  for (auto& m : left) {
-    m.set_gearing(pros::E_MOTOR_GEAR_BLUE);
-    m.set_encoder_units(pros::E_MOTOR_ENCODER_DEGREES);
-    m.set_brake_mode(pros::E_MOTOR_BRAKE_COAST);
-    m.set_reversed(false); // change if needed
-  }
-
-  for (auto& m : right) {
-    m.set_gearing(pros::E_MOTOR_GEAR_BLUE);
-    m.set_encoder_units(pros::E_MOTOR_ENCODER_DEGREES);
-    m.set_brake_mode(pros::E_MOTOR_BRAKE_COAST);
-    m.set_reversed(true); // VERY COMMON on tank drives; flip if wrong
-  }
 
-  lastMs = pros::millis();
+Drive::Drive(hal::DriveIO& io)
+  : io(io)
+  , ff{constants::DRIVE_KS, constants::DRIVE_KV, constants::DRIVE_KA}
+  , angularFf{constants::TURN_KS, constants::TURN_KV, constants::TURN_KA} {
+  lastMs = hal::millis();
+  leftSlew.setLog(&leftSlewLog);
+  rightSlew.setLog(&rightSlewLog);
 }
 
 void Drive::calibrateImu() {
-  imu.reset();
-  while (imu.is_calibrating()) {
-    pros::delay(20);
-  }
+  io.calibrateImu();
 }
 
 void Drive::tank(int leftPct, int rightPct) {
@@ -54,121 +39,189 @@ void Drive::setVoltage(int leftMv, int rightMv) {
   // Clamp to safe range
   leftMv  = std::max(-constants::MAX_VOLTAGE, std::min(constants::MAX_VOLTAGE, leftMv));
   rightMv = std::max(-constants::MAX_VOLTAGE, std::min(constants::MAX_VOLTAGE, rightMv));
+  commandLeft = leftMv;
+  commandRight = rightMv;
+
+  int now = hal::millis();
+  double dt = (now - lastMs) / 1000.0;
+  if (dt < 0) dt = 0;
+  if (dt > 0.05) dt = 0.05; // safety clamp if something stalls
+  lastMs = now;
 
   // Slew limiting
   if (slewEnabled) {
-    int now = pros::millis();
-    double dt = (now - lastMs) / 1000.0;
-    if (dt < 0) dt = 0;
-    if (dt > 0.05) dt = 0.05; // safety clamp if something stalls
-    lastMs = now;
-
     leftMv  = (int)leftSlew.step((double)leftMv, dt);
     rightMv = (int)rightSlew.step((double)rightMv, dt);
   }
 
-  for (auto& m : left)  m.move_voltage(leftMv);
-  for (auto& m : right) m.move_voltage(rightMv);
+  // Nominal -> actual millivolts. The filter keeps motor-current ripple out
+  // of the scale; a dead reading leaves the last good value
+  const double battery = io.batteryMv();
+  if (battery > constants::NOMINAL_BATTERY_MV / 2) {
+    if (batteryFilteredMv <= 0) batteryFilteredMv = battery;
+    else batteryFilteredMv += (battery - batteryFilteredMv) * std::min(dt / constants::BATTERY_FILTER_TAU_S, 1.0);
+  }
+  const double compensation = batteryFilteredMv > 0 ? constants::NOMINAL_BATTERY_MV / batteryFilteredMv : 1.0;
+
+  // Past the motors' ceiling both sides shrink by one factor, so the
+  // left/right ratio (the curvature) survives a low battery
+  double s = scale.load(std::memory_order_relaxed) * compensation;
+  const double peak = std::max(std::abs(leftMv), std::abs(rightMv)) * s;
+  if (peak > constants::MAX_VOLTAGE) s *= constants::MAX_VOLTAGE / peak;
+  io.setVoltage((int)std::lround(leftMv * s), (int)std::lround(rightMv * s));
 }
 
 
 void Drive::brakeHold(bool enabled) {
-  const auto mode = enabled ? pros::E_MOTOR_BRAKE_HOLD : pros::E_MOTOR_BRAKE_COAST;
-  for (auto& m : left)  m.set_brake_mode(mode);
-  for (auto& m : right) m.set_brake_mode(mode);
+  io.setBrakeHold(enabled);
 }
 
 void Drive::tareEncoders() {
-  for (auto& m : left)  m.tare_position();
-  for (auto& m : right) m.tare_position();
+  io.tare();
 
   // Reset slew so next command doesn't ramp from an old value
   leftSlew.reset(0);
   rightSlew.reset(0);
-  lastMs = pros::millis();
+  lastMs = hal::millis();
 }
 
 void Drive::turnTo(double targetHeadingDeg) {
-  // Basic turn PID gains (starter). You will tune on the robot.
-  // For IMU degrees -> motor millivolts, kP usually starts around 80-150.
-  PID pid(110.0, 0.0, 650.0);
+  // Follows a heading profile with the angular feedforward, PID trimming
+  // the error to the profile. One controller for every error size: stiff
+  // with some I near the reference to push through static friction, softer
+  // far out (a stall or a hit) where a stiff D would only brake the swing.
+  motion_command::claim();
+  // IMU degrees -> motor millivolts.
+  const PID::GainPoint schedule[] = {
+    {2.0,  turnNear},
+    {20.0, {turnNear.kP * 0.5,   0.0, turnNear.kD * 0.57}},
+    {90.0, {turnNear.kP * 0.275, 0.0, turnNear.kD * 0.57}},
+  };
+  PID pid(0.0, 0.0, 0.0);
+  pid.setGainSchedule(schedule, sizeof(schedule) / sizeof(schedule[0]));
+  pid.setDerivativeFilter(0.02);
   pid.setOutputLimit(constants::MAX_VOLTAGE);
+  pid.setLog(&turnLog);
+
+  const double startHeading = headingDeg();
+  const MotionProfile profile(angleErrorDeg(targetHeadingDeg, startHeading),
+                              ProfileConstraints{constants::TURN_MAX_VEL, constants::TURN_MAX_ACCEL, constants::TURN_MAX_JERK});
 
-  const int dtMs = 10;
-  const double dt = dtMs / 1000.0;
+  // The profile already limits rate of change; slew would only add lag
+  const bool slewWas = slewEnabled;
+  slewEnabled = false;
+
+  FixedRate rate("turnTo", 10);
+  double dt = rate.periodSec();
 
   int settleCount = 0;
   const int settleNeeded = 15;     // 15 * 10ms = 150ms stable
   const double settleErrDeg = 1.0; // within 1 degree
-  const int timeoutMs = 2000;
+  const std::uint32_t timeoutMs = (std::uint32_t)(profile.duration() * 1000.0) + 1000;
 
-  int elapsed = 0;
+  const double startErr = std::max(std::abs(angleErrorDeg(targetHeadingDeg, startHeading)), 1e-6);
 
-  leftSlew.reset(0);
-  rightSlew.reset(0);
-  lastMs = pros::millis();
-
-  while (elapsed < timeoutMs) {
+  while (rate.elapsedMs() < timeoutMs) {
     const double current = headingDeg();
     const double err = angleErrorDeg(targetHeadingDeg, current);
 
-    const double output = pid.step(0.0, -err, dt);
-    // Explanation: our PID assumes target-current. We want "error" to be the wrapped err.
-    // Using target=0, current=-err makes (0 - (-err)) = err.
+    if (!motion_command::tick(0.0, 1.0 - std::abs(err) / startErr)) break;
+
+    const double t = rate.elapsedMs() / 1000.0;
+    const ProfileState ref = profile.sample(t);
+    const double trackErr = angleErrorDeg(startHeading + ref.pos, current);
+
+    // Our PID assumes target - current; target 0, current -trackErr gives
+    // the wrapped error
+    // While the profile runs the error is tracking lag, which reverses in the
+    // deceleration; integrating it would only add overshoot
+    pid.setIntegralBand(t >= profile.duration() ? 5.0 : 0.0);
+    const double output = angularFf.calc(ref.vel, ref.acc) + pid.step(0.0, -trackErr, dt);
 
     // Turn in place: left +, right -
     setVoltage((int)output, (int)-output);
 
-    if (std::abs(err) < settleErrDeg) settleCount++;
+    if (t >= profile.duration() && std::abs(err) < settleErrDeg) settleCount++;
     else settleCount = 0;
 
     if (settleCount >= settleNeeded) break;
 
-    pros::delay(dtMs);
-    elapsed += dtMs;
+    dt = rate.wait();
   }
 
   setVoltage(0, 0);
+  slewEnabled = slewWas;
   leftSlew.reset(0);
   rightSlew.reset(0);
-  lastMs = pros::millis();
-
+  lastMs = hal::millis();
 }
 
 void Drive::driveDistance(double inches, double headingHoldDeg) {
-  // Reset encoder baseline
-  tareEncoders();
+  driveDistance(inches,
+                ProfileConstraints{constants::DRIVE_MAX_VEL, constants::DRIVE_MAX_ACCEL, constants::DRIVE_MAX_JERK},
+                headingHoldDeg);
+}
+
+void Drive::driveDistance(double inches, const ProfileConstraints& limits, double headingHoldDeg) {
+  motion_command::claim();
+
+  // Measure from here rather than taring: Odom reads the same encoders
+  const hal::DriveSample start = sample();
 
   // If user didn't specify heading, hold the heading we start with
   if (std::isnan(headingHoldDeg)) headingHoldDeg = headingDeg();
 
-  // PID for distance (inches)
-  PID dist(850.0, 0.0, 4200.0); // starter gains (will tune)
-  dist.setOutputLimit(constants::MAX_VOLTAGE);
+  const MotionProfile profile(inches, limits);
+
+  // Trim on top of feedforward
+  PID posTrim(distance.kP, distance.kI, 0.0);  // mV per inch behind the profile
+  const double kVelTrim = distance.kD;          // mV per in/s behind the profile
+  posTrim.setOutputLimit(constants::MAX_VOLTAGE);
+  posTrim.setLog(&distLog);
 
   // Heading correction (P-only to start)
   // Output is millivolts added/subtracted to keep straight
   const double kHeadingP = 80.0;
 
-  const int dtMs = 10;
-  const double dt = dtMs / 1000.0;
+  // The profile already limits rate of change; slew would only add lag
+  const bool slewWas = slewEnabled;
+  slewEnabled = false;
+
+  FixedRate rate("driveDistance", 10);
+  double dt = rate.periodSec();
 
   int settleCount = 0;
-  const int settleNeeded = 20;       // 200ms stable
+  const int settleNeeded = 5;        // 50ms stable once the profile is done
   const double settleErrIn = 0.25;   // within 1/4 inch
-  const int timeoutMs = 3000;
+  const std::uint32_t timeoutMs = (std::uint32_t)(profile.duration() * 1000.0) + 500;
 
-  int elapsed = 0;
+  // Measured velocity from device-timestamped samples
+  hal::DriveSample lastEnc = start;
+  double lastAvgIn = 0.0;
+  double velIn = 0.0;
 
-  while (elapsed < timeoutMs) {
-    const double leftIn  = constants::motorDegToInches(leftMotorDeg());
-    const double rightIn = constants::motorDegToInches(rightMotorDeg());
+  while (rate.elapsedMs() < timeoutMs) {
+    const hal::DriveSample enc = sample();
+    const double leftIn  = constants::motorDegToInches(enc.leftDeg - start.leftDeg);
+    const double rightIn = constants::motorDegToInches(enc.rightDeg - start.rightDeg);
     const double avgIn = (leftIn + rightIn) / 2.0;
 
-    const double errorIn = inches - avgIn;
+    const std::uint32_t sampleDtMs = (enc.leftTimeMs + enc.rightTimeMs) / 2 - (lastEnc.leftTimeMs + lastEnc.rightTimeMs) / 2;
+    if (sampleDtMs > 0) {
+      velIn = 0.5 * velIn + 0.5 * (avgIn - lastAvgIn) / (sampleDtMs / 1000.0);
+      lastAvgIn = avgIn;
+      lastEnc = enc;
+    }
+
+    if (!motion_command::tick(std::abs(avgIn), inches != 0 ? avgIn / inches : 1.0)) break;
+
+    const double t = rate.elapsedMs() / 1000.0;
+    const ProfileState ref = profile.sample(t);
 
-    // Distance output (forward power)
-    const double forwardMv = dist.step(inches, avgIn, dt);
+    // Distance output (forward power): model + trim
+    const double forwardMv = ff.calc(ref.vel, ref.acc)
+                           + posTrim.step(ref.pos, avgIn, dt)
+                           + kVelTrim * (ref.vel - velIn);
 
     // Heading correction
     const double currentHeading = headingDeg();
@@ -181,19 +234,36 @@ void Drive::driveDistance(double inches, double headingHoldDeg) {
 
     setVoltage(leftMv, rightMv);
 
-    if (std::abs(errorIn) < settleErrIn) settleCount++;
+    const double errorIn = inches - avgIn;
+    if (t >= profile.duration() && std::abs(errorIn) < settleErrIn) settleCount++;
     else settleCount = 0;
 
     if (settleCount >= settleNeeded) break;
 
-    pros::delay(dtMs);
-    elapsed += dtMs;
+    dt = rate.wait();
   }
 
   setVoltage(0, 0);
+  slewEnabled = slewWas;
   leftSlew.reset(0);
   rightSlew.reset(0);
-  lastMs = pros::millis();
+  lastMs = hal::millis();
+}
+
+void Drive::setFeedforward(const Feedforward& model) {
+  ff = model;
+}
+
+void Drive::setAngularFeedforward(const Feedforward& model) {
+  angularFf = model;
+}
+
+void Drive::setTurnGains(const PID::Gains& near) {
+  turnNear = near;
+}
+
+void Drive::setDistanceGains(const PID::Gains& gains) {
+  distance = gains;
 }
 
 void Drive::arcade(int forwardPct, int turnPct) {
@@ -218,21 +288,32 @@ void Drive::setSlewRate(double mvPerSec) {
 void Drive::resetSlew() {
   leftSlew.reset(0);
   rightSlew.reset(0);
-  lastMs = pros::millis();
+  lastMs = hal::millis();
 }
 
 
+hal::DriveSample Drive::sample() const {
+  return io.sample();
+}
+
 double Drive::leftMotorDeg() const {
-  return avgMotorPositionDeg(left);
+  return io.sample().leftDeg;
 }
 
 double Drive::rightMotorDeg() const {
-  return avgMotorPositionDeg(right);
+  return io.sample().rightDeg;
 }
 
 double Drive::headingDeg() const {
-  // PROS IMU returns 0..360 typically
-  return imu.get_heading();
+  return io.headingDeg();
+}
+
+double Drive::yawRateDps() const {
+  return io.yawRateDps();
+}
+
+double Drive::forwardAccelG() const {
+  return io.forwardAccelG();
 }
 
 
@@ -0,0 +1,202 @@
+#include "drive/sysid.hpp"
+#include "config/constants.hpp"
+#include "control/command.hpp"
+#include "control/executive.hpp"
+#include "hal/rtos.hpp"
+#include "util/units.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+  // Normal equations for y = kS*sign(v) + kV*v + kA*a
+  struct LeastSquares {
+    double xtx[3][3]{};
+    double xty[3]{};
+    double yty{0.0};
+    double ySum{0.0};
+    int n{0};
+
+    void add(double y, double v, double a) {
+      const double x[3] = {(double)((v > 0) - (v < 0)), v, a};
+      for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 3; c++) xtx[r][c] += x[r] * x[c];
+        xty[r] += x[r] * y;
+      }
+      yty += y * y;
+      ySum += y;
+      n++;
+    }
+
+    // Gaussian elimination with partial pivoting on a copy
+    bool solve(sysid::Fit& out) const {
+      if (n < 10) return false;
+
+      double m[3][4];
+      for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 3; c++) m[r][c] = xtx[r][c];
+        m[r][3] = xty[r];
+      }
+
+      for (int col = 0; col < 3; col++) {
+        int pivot = col;
+        for (int r = col + 1; r < 3; r++)
+          if (std::abs(m[r][col]) > std::abs(m[pivot][col])) pivot = r;
+        if (std::abs(m[pivot][col]) < 1e-9) return false;
+        if (pivot != col) for (int c = 0; c < 4; c++) std::swap(m[col][c], m[pivot][c]);
+
+        for (int r = 0; r < 3; r++) {
+          if (r == col) continue;
+          const double f = m[r][col] / m[col][col];
+          for (int c = col; c < 4; c++) m[r][c] -= f * m[col][c];
+        }
+      }
+
+      const double b[3] = {m[0][3] / m[0][0], m[1][3] / m[1][1], m[2][3] / m[2][2]};
+
+      // SSE = y'y - 2b'X'y + b'X'Xb
+      double sse = yty;
+      for (int r = 0; r < 3; r++) {
+        sse -= 2.0 * b[r] * xty[r];
+        for (int c = 0; c < 3; c++) sse += b[r] * xtx[r][c] * b[c];
+      }
+      const double sst = yty - ySum * ySum / n;
+
+      out.model = Feedforward{b[0], b[1], b[2]};
+      out.r2 = sst > 0 ? 1.0 - sse / sst : 0.0;
+      out.samples = n;
+      return true;
+    }
+  };
+
+  enum class Mode { Linear, Angular };
+
+  constexpr double MIN_LINEAR_VEL = 1.0;    // in/s; below this we're still in stiction
+  constexpr double MIN_ANGULAR_VEL = 10.0;  // deg/s
+
+  // Interval velocities and the voltage held over each, newest last. The
+  // middle interval gets a centered-difference acceleration.
+  struct History {
+    double vel[3]{};
+    double mv[3]{};
+    int n{0};
+
+    void push(double v, double appliedMv, double dt, double minVel, LeastSquares& ls) {
+      vel[0] = vel[1]; vel[1] = vel[2]; vel[2] = v;
+      mv[0] = mv[1]; mv[1] = mv[2]; mv[2] = appliedMv;
+      if (++n < 3) return;
+      const double acc = (vel[2] - vel[0]) / (2.0 * dt);
+      if (std::abs(vel[1]) > minVel) ls.add(mv[1], vel[1], acc);
+    }
+  };
+
+  // One ramp or step in direction dir (+1/-1). Linear tests add a sample per
+  // side per tick; angular tests add the IMU body rate against left voltage.
+  void runTest(Drive& drive, Mode mode, double dir, bool ramp,
+               const sysid::Settings& cfg, LeastSquares& ls) {
+    const std::uint32_t durationMs = ramp
+      ? (std::uint32_t)(cfg.rampMaxMv / cfg.rampMvPerSec * 1000.0)
+      : cfg.stepMs;
+
+    hal::DriveSample last = drive.sample();
+    double lastHeading = drive.headingDeg();
+    History left, right, body;
+    double appliedMv = 0.0;
+
+    FixedRate rate("sysid", 10);
+    double dt = rate.periodSec();
+    while (rate.elapsedMs() < durationMs) {
+      // Measure the interval the previous voltage was applied over
+      if (mode == Mode::Linear) {
+        const hal::DriveSample s = drive.sample();
+        const double leftDt = std::max(1u, s.leftTimeMs - last.leftTimeMs) / 1000.0;
+        const double rightDt = std::max(1u, s.rightTimeMs - last.rightTimeMs) / 1000.0;
+        left.push(constants::motorDegToInches(s.leftDeg - last.leftDeg) / leftDt,
+                  appliedMv, leftDt, MIN_LINEAR_VEL, ls);
+        right.push(constants::motorDegToInches(s.rightDeg - last.rightDeg) / rightDt,
+                   appliedMv, rightDt, MIN_LINEAR_VEL, ls);
+        last = s;
+      } else {
+        const double heading = drive.headingDeg();
+        body.push(-angleErrorDeg(lastHeading, heading) / dt, appliedMv, dt, MIN_ANGULAR_VEL, ls);
+        lastHeading = heading;
+      }
+
+      const double t = rate.elapsedMs() / 1000.0;
+      appliedMv = dir * (ramp ? std::min(cfg.rampMvPerSec * t, cfg.rampMaxMv) : cfg.stepMv);
+      const int mv = (int)appliedMv;
+      drive.setVoltage(mv, mode == Mode::Linear ? mv : -mv);
+
+      dt = rate.wait();
+    }
+
+    // Hold to a full stop so the next test starts from rest
+    drive.brakeHold(true);
+    drive.setVoltage(0, 0);
+    hal::delay(750);
+    drive.brakeHold(false);
+  }
+}
+
+namespace sysid {
+
+Result run(Drive& drive, const Settings& cfg) {
+  motion_command::claim();
+  Result r{};
+  const double startHeading = drive.headingDeg();
+
+  drive.enableSlew(false);
+
+  // Forward then back each time so the robot ends up near where it started
+  LeastSquares linear;
+  runTest(drive, Mode::Linear, +1, true, cfg, linear);
+  runTest(drive, Mode::Linear, -1, true, cfg, linear);
+  runTest(drive, Mode::Linear, +1, false, cfg, linear);
+  runTest(drive, Mode::Linear, -1, false, cfg, linear);
+
+  LeastSquares angular;
+  runTest(drive, Mode::Angular, +1, true, cfg, angular);
+  runTest(drive, Mode::Angular, -1, true, cfg, angular);
+  runTest(drive, Mode::Angular, +1, false, cfg, angular);
+  runTest(drive, Mode::Angular, -1, false, cfg, angular);
+
+  drive.enableSlew(true);
+  drive.resetSlew();
+  drive.turnTo(startHeading);
+
+  r.ok = linear.solve(r.linear) && angular.solve(r.angular);
+  if (!r.ok) return r;
+
+  drive.setFeedforward(r.linear.model);
+  drive.setAngularFeedforward(r.angular.model);
+  return r;
+}
+
+bool save(const Drive& drive, const char* path) {
+  FILE* f = std::fopen(path, "w");
+  if (!f) return false;
+  const Feedforward l = drive.feedforward();
+  const Feedforward a = drive.angularFeedforward();
+  std::fprintf(f, "linear %.4f %.4f %.4f\n", l.kS, l.kV, l.kA);
+  std::fprintf(f, "angular %.4f %.4f %.4f\n", a.kS, a.kV, a.kA);
+  std::fclose(f);
+  return true;
+}
+
+bool load(Drive& drive, const char* path) {
+  FILE* f = std::fopen(path, "r");
+  if (!f) return false;
+
+  char key[16];
+  Feedforward ff;
+  int found = 0;
+  while (std::fscanf(f, "%15s %lf %lf %lf", key, &ff.kS, &ff.kV, &ff.kA) == 4) {
+    if (std::strcmp(key, "linear") == 0) { drive.setFeedforward(ff); found++; }
+    else if (std::strcmp(key, "angular") == 0) { drive.setAngularFeedforward(ff); found++; }
+  }
+  std::fclose(f);
+  return found > 0;
+}
+
+}
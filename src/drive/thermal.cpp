@@ -0,0 +1,139 @@
+#include "drive/thermal.hpp"
+#include "control/executive.hpp"
+#include "hal/rtos.hpp"
+#include "telemetry/telemetry.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+  telemetry::Channel thermalLog("thermal", "leftC,rightC,leftA,rightA,budget,timeToLimit");
+
+  constexpr std::uint32_t PERIOD_MS = 100;    // temperature/current are slow device reads
+
+  // Blue motor, per motor: winding resistance and a lumped thermal mass.
+  // Starters; k absorbs the error and the sensor steps keep T honest.
+  constexpr double LIMIT_C = 55.0;
+  constexpr double SENSOR_STEP_C = 5.0;       // reading = T rounded down to a step
+  constexpr double AMBIENT_C = 25.0;
+  constexpr double WINDING_OHM = 4.8;         // 12 V / 2.5 A stall
+  constexpr double THERMAL_RES_K_PER_W = 3.0;
+  constexpr double THERMAL_CAP_J_PER_K = 40.0;
+  constexpr double TAU_S = THERMAL_RES_K_PER_W * THERMAL_CAP_J_PER_K;
+
+  constexpr double AVG_TAU_S = 10.0;          // heating history behind predictions
+  constexpr double GAIN_LEARN = 0.5;          // of the way to each edge's estimate
+  constexpr double MIN_GAIN = 0.5;
+  constexpr double MAX_GAIN = 3.0;
+
+  // Budgeting: aim a little under the limit, never below MIN_BUDGET, and
+  // move slowly enough that the driver doesn't feel a step
+  constexpr double MARGIN_C = 2.0;
+  constexpr double MIN_BUDGET = 0.6;
+  constexpr double BUDGET_DOWN_PER_S = 0.05;
+  constexpr double BUDGET_UP_PER_S = 0.1;
+}
+
+Thermal::Thermal(Drive& drive)
+  : drive(drive), published(Status{{0, 0, 0, INFINITY}, {0, 0, 0, INFINITY}, 1.0, false}) {}
+
+void Thermal::start() {
+  // One task owns the models; a second start() is a no-op
+  if (running.exchange(true)) return;
+  hal::startTask([this]() { this->loop(); }, "Thermal", hal::PRIORITY_LOW);
+}
+
+void Thermal::setDeadline(std::uint32_t atMs) {
+  deadlineMs.store(atMs);
+}
+
+Thermal::Status Thermal::status() const {
+  return published.load();
+}
+
+double Thermal::timeToLimitS() const {
+  const Status s = published.load();
+  return std::min(s.left.timeToLimitS, s.right.timeToLimitS);
+}
+
+void Thermal::update(Model& m, Side& out, double sensorC, double currentA, double dt) {
+  // First read: middle of the band
+  if (m.lastSensorC < 0) m.tempC = sensorC + SENSOR_STEP_C / 2.0;
+
+  const double rawWatts = currentA * currentA * WINDING_OHM;
+  const double coolWatts = (m.tempC - AMBIENT_C) / THERMAL_RES_K_PER_W;
+  const double watts = m.heatGain * rawWatts;
+  m.tempC += (watts - coolWatts) / THERMAL_CAP_J_PER_K * dt;
+  m.avgWatts += (watts - m.avgWatts) * std::min(dt / AVG_TAU_S, 1.0);
+  m.heatJ += rawWatts * dt;
+  m.coolJ += coolWatts * dt;
+
+  // Two rising steps in a row pin the real rise between them to exactly one
+  // step, which is linear in k: C * step = k * heat - cooling
+  if (m.lastSensorC >= 0 && sensorC > m.lastSensorC) {
+    if (m.sinceEdge && m.heatJ > 0) {
+      const double observed = (SENSOR_STEP_C * THERMAL_CAP_J_PER_K + m.coolJ) / m.heatJ;
+      m.heatGain = std::clamp(m.heatGain + GAIN_LEARN * (observed - m.heatGain), MIN_GAIN, MAX_GAIN);
+    }
+    m.tempC = sensorC;
+    m.sinceEdge = sensorC - m.lastSensorC == SENSOR_STEP_C;
+    m.heatJ = m.coolJ = 0.0;
+  } else if (sensorC < m.lastSensorC) {
+    m.sinceEdge = false;
+  }
+  m.tempC = std::clamp(m.tempC, sensorC, sensorC + SENSOR_STEP_C);
+  m.lastSensorC = sensorC;
+
+  // T(t) = steady + (T - steady) e^(-t/tau), solved for T(t) = limit
+  const double steady = AMBIENT_C + m.avgWatts * THERMAL_RES_K_PER_W;
+  double timeToLimit = INFINITY;
+  if (m.tempC >= LIMIT_C) timeToLimit = 0.0;
+  else if (steady > LIMIT_C) timeToLimit = -TAU_S * std::log((LIMIT_C - steady) / (m.tempC - steady));
+
+  out = Side{m.tempC, sensorC, currentA, timeToLimit};
+}
+
+// Output scale that lands the model at the limit (less margin) no sooner
+// than horizonS from now. Heat goes as current squared, roughly as output
+// squared, and avgWatts was measured under the current budget.
+double Thermal::allowedScale(const Model& m, double horizonS) const {
+  const double target = LIMIT_C - MARGIN_C;
+  if (m.tempC >= target) return MIN_BUDGET;
+
+  const double decay = std::exp(-horizonS / TAU_S);
+  const double steadyAllowed = (target - m.tempC * decay) / (1.0 - decay);
+  const double wattsAllowed = (steadyAllowed - AMBIENT_C) / THERMAL_RES_K_PER_W;
+  const double wattsDemanded = m.avgWatts / (budget * budget);
+  if (wattsAllowed >= wattsDemanded) return 1.0;
+  return std::clamp(std::sqrt(std::max(wattsAllowed, 0.0) / wattsDemanded), MIN_BUDGET, 1.0);
+}
+
+void Thermal::loop() {
+  FixedRate rate("Thermal", PERIOD_MS);
+  double dt = rate.periodSec();
+
+  while (true) {
+    const hal::DrivePower p = drive.power();
+    Status s;
+    update(leftModel, s.left, p.leftTempC, p.leftCurrentA, dt);
+    update(rightModel, s.right, p.rightTempC, p.rightCurrentA, dt);
+
+    double target = 1.0;
+    const std::uint32_t deadline = deadlineMs.load();
+    const std::uint32_t now = hal::millis();
+    if (deadline != 0 && deadline > now) {
+      const double horizonS = (deadline - now) / 1000.0;
+      target = std::min(allowedScale(leftModel, horizonS), allowedScale(rightModel, horizonS));
+    }
+    const double step = (target < budget ? BUDGET_DOWN_PER_S : BUDGET_UP_PER_S) * dt;
+    budget += std::clamp(target - budget, -step, step);
+    drive.setOutputScale(budget);
+
+    s.budget = budget;
+    s.overTemp = p.overTemp;
+    published.store(s);
+    thermalLog.log(s.left.tempC, s.right.tempC, s.left.currentA, s.right.currentA, budget,
+                   std::min(s.left.timeToLimitS, s.right.timeToLimitS));
+
+    dt = rate.wait();
+  }
+}
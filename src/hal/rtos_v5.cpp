@@ -0,0 +1,20 @@
+#include "hal/rtos.hpp"
+#include "pros/rtos.hpp"
+
+namespace hal {
+  std::uint32_t millis() { return pros::millis(); }
+
+  std::uint64_t micros() { return pros::micros(); }
+
+  void delay(std::uint32_t ms) { pros::delay(ms); }
+
+  void delayUntil(std::uint32_t* prevMs, std::uint32_t periodMs) {
+    pros::Task::delay_until(prevMs, periodMs);
+  }
+
+  void startTask(std::function<void()> fn, const char* name, std::uint32_t priority) {
+    pros::Task(std::move(fn), priority, TASK_STACK_DEPTH_DEFAULT, name);
+  }
+
+  std::uintptr_t currentTask() { return (std::uintptr_t)pros::c::task_get_current(); }
+}
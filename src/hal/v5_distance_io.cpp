@@ -0,0 +1,28 @@
+#include "hal/v5_distance_io.hpp"
+#include "pros/error.h"
+
+namespace hal {
+
+static constexpr double MM_PER_IN = 25.4;
+static constexpr int MIN_CONFIDENCE = 32;   // of 63; only meaningful > 200 mm
+
+V5DistanceIO::V5DistanceIO(int p0, int p1, int p2, int p3)
+  : sensors{pros::Distance(p0), pros::Distance(p1), pros::Distance(p2), pros::Distance(p3)}, n(0) {
+  // Fitted sensors come first
+  const int ports[MAX] = {p0, p1, p2, p3};
+  while (n < MAX && ports[n] != 0) n++;
+}
+
+DistanceIO::Reading V5DistanceIO::readIn(int i, double& out) {
+  if (i < 0 || i >= n) return Reading::INVALID;
+
+  const std::int32_t mm = sensors[i].get_distance();
+  if (mm == PROS_ERR || mm <= 0) return Reading::INVALID;
+  if (mm > MAX_RANGE_IN * MM_PER_IN) return Reading::NO_RETURN;   // reports 9999 past its range
+  if (mm > 200 && sensors[i].get_confidence() < MIN_CONFIDENCE) return Reading::INVALID;
+
+  out = mm / MM_PER_IN;
+  return Reading::HIT;
+}
+
+}
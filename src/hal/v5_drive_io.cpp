@@ -0,0 +1,132 @@
+#include "hal/v5_drive_io.hpp"
+#include "pros/error.h"
+#include "pros/misc.hpp"
+#include "pros/rtos.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace hal {
+
+// Blue cartridge: 300 raw counts per output shaft revolution
+static constexpr double COUNTS_PER_DEG = 300.0 / 360.0;
+
+// Motors are read one index at a time: the *_all() calls build a
+// std::vector per call, and these run in the 10ms loops.
+// Unplugged motors read PROS_ERR / PROS_ERR_F; leave them out.
+
+// Timestamp is the newest of the side's readings
+static double avgRawCounts(const pros::MotorGroup& motors, std::uint32_t* timestampMs) {
+  double sum = 0.0;
+  int n = 0;
+  for (std::uint8_t i = 0; i < motors.size(); i++) {
+    std::uint32_t ts = 0;
+    const std::int32_t c = motors.get_raw_position(&ts, i);
+    if (c == PROS_ERR) continue;
+    sum += c;
+    n++;
+    if (timestampMs && (n == 1 || ts > *timestampMs)) *timestampMs = ts;
+  }
+  return n ? sum / n : 0.0;
+}
+
+static double hottestC(const pros::MotorGroup& motors) {
+  double hottest = 0.0;
+  for (std::uint8_t i = 0; i < motors.size(); i++) {
+    const double t = motors.get_temperature(i);
+    if (std::isfinite(t)) hottest = std::max(hottest, t);
+  }
+  return hottest;
+}
+
+static double meanCurrentA(const pros::MotorGroup& motors) {
+  double sum = 0.0;
+  int n = 0;
+  for (std::uint8_t i = 0; i < motors.size(); i++) {
+    const std::int32_t ma = motors.get_current_draw(i);
+    if (ma == PROS_ERR) continue;
+    sum += std::abs(ma);
+    n++;
+  }
+  return n ? sum / n / 1000.0 : 0.0;
+}
+
+static bool anyOverTemp(const pros::MotorGroup& motors) {
+  for (std::uint8_t i = 0; i < motors.size(); i++) {
+    if (motors.is_over_temp(i) == 1) return true;
+  }
+  return false;
+}
+
+// Common convention:
+// Left motors forward = +, Right motors forward = +.
+// Right side is reversed via negative ports (VERY COMMON on tank drives; flip if wrong).
+// Reversal through the port sign also negates raw encoder counts.
+V5DriveIO::V5DriveIO(int l1, int l2, int l3, int r1, int r2, int r3, int imuPort)
+  : left({ (std::int8_t)l1, (std::int8_t)l2, (std::int8_t)l3 },
+         pros::v5::MotorGears::blue, pros::v5::MotorUnits::degrees)
+  , right({ (std::int8_t)-r1, (std::int8_t)-r2, (std::int8_t)-r3 },
+          pros::v5::MotorGears::blue, pros::v5::MotorUnits::degrees)
+  , imu(imuPort) {
+
+  left.set_brake_mode_all(pros::E_MOTOR_BRAKE_COAST);
+  right.set_brake_mode_all(pros::E_MOTOR_BRAKE_COAST);
+}
+
+void V5DriveIO::setVoltage(int leftMv, int rightMv) {
+  left.move_voltage(leftMv);
+  right.move_voltage(rightMv);
+}
+
+void V5DriveIO::setBrakeHold(bool enabled) {
+  const auto mode = enabled ? pros::E_MOTOR_BRAKE_HOLD : pros::E_MOTOR_BRAKE_COAST;
+  left.set_brake_mode_all(mode);
+  right.set_brake_mode_all(mode);
+}
+
+void V5DriveIO::tare() {
+  left.tare_position_all();
+  right.tare_position_all();
+  leftZeroCounts = avgRawCounts(left, nullptr);
+  rightZeroCounts = avgRawCounts(right, nullptr);
+}
+
+DriveSample V5DriveIO::sample() const {
+  DriveSample s{};
+  s.leftDeg = (avgRawCounts(left, &s.leftTimeMs) - leftZeroCounts) / COUNTS_PER_DEG;
+  s.rightDeg = (avgRawCounts(right, &s.rightTimeMs) - rightZeroCounts) / COUNTS_PER_DEG;
+  return s;
+}
+
+double V5DriveIO::headingDeg() const {
+  // PROS IMU returns 0..360 typically
+  return imu.get_heading();
+}
+
+double V5DriveIO::yawRateDps() const {
+  // Gyro z is right-handed (CCW positive looking down), heading is CW positive
+  return -imu.get_gyro_rate().z;
+}
+
+double V5DriveIO::forwardAccelG() const {
+  // Assumes the IMU is mounted flat with its x axis pointing forward
+  return imu.get_accel().x;
+}
+
+void V5DriveIO::calibrateImu() {
+  imu.reset();
+  while (imu.is_calibrating()) {
+    pros::delay(20);
+  }
+}
+
+DrivePower V5DriveIO::power() const {
+  return DrivePower{hottestC(left), hottestC(right), meanCurrentA(left), meanCurrentA(right),
+                    anyOverTemp(left) || anyOverTemp(right)};
+}
+
+double V5DriveIO::batteryMv() const {
+  return pros::battery::get_voltage();
+}
+
+}
@@ -0,0 +1,30 @@
+#include "hal/v5_gps_io.hpp"
+#include "config/constants.hpp"
+#include "pros/error.h"
+#include "pros/rtos.hpp"
+
+namespace hal {
+
+static constexpr double IN_PER_M = 1.0 / 0.0254;
+
+V5GpsIO::V5GpsIO(int port, double xOffsetIn, double yOffsetIn)
+  : gps(port, xOffsetIn / IN_PER_M, yOffsetIn / IN_PER_M) {}
+
+bool V5GpsIO::read(GpsSample& out) const {
+  const pros::gps_status_s_t s = gps.get_position_and_orientation();
+  const double error = gps.get_error();
+  if (s.x == PROS_ERR_F || error == PROS_ERR_F) return false;
+
+  // GPS heading is clockwise from field +y, like our theta from odom +x,
+  // so odom x is GPS y and odom y is GPS x
+  out.xIn = s.y * IN_PER_M;
+  out.yIn = s.x * IN_PER_M;
+  out.headingDeg = gps.get_heading();
+  out.errorIn = error * IN_PER_M;
+
+  // No device timestamp; the fix lags by the sensor's processing time
+  out.timeMs = pros::millis() - constants::GPS_LATENCY_MS;
+  return true;
+}
+
+}
@@ -0,0 +1,33 @@
+#include "hal/v5_tracking_io.hpp"
+#include "pros/error.h"
+
+namespace hal {
+
+namespace {
+  // get_position() is in centidegrees, PROS_ERR if the sensor is unplugged
+  bool readDeg(const pros::Rotation& sensor, double& deg) {
+    const std::int32_t centi = sensor.get_position();
+    if (centi == PROS_ERR) return false;
+    deg = centi / 100.0;
+    return true;
+  }
+}
+
+V5TrackingIO::V5TrackingIO(int leftPort, int rightPort, int backPort)
+  : left(leftPort), right(rightPort), back(backPort) {
+  // 5ms is the fastest the sensor reports; odom runs at 10ms
+  left.set_data_rate(5);
+  right.set_data_rate(5);
+  back.set_data_rate(5);
+}
+
+bool V5TrackingIO::read(TrackingSample& out) const {
+  // Read all three so the good ones stay current
+  bool ok = readDeg(left, last.leftDeg);
+  ok = readDeg(right, last.rightDeg) && ok;
+  ok = readDeg(back, last.backDeg) && ok;
+  out = last;
+  return ok;
+}
+
+}
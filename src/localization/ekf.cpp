@@ -0,0 +1,89 @@
+#include "localization/ekf.hpp"
+#include <cmath>
+
+static double wrapRad(double a) {
+  while (a > M_PI) a -= 2 * M_PI;
+  while (a < -M_PI) a += 2 * M_PI;
+  return a;
+}
+
+Ekf::Ekf(const Noise& noise) : noise(noise) {
+  reset(Pose{0, 0, 0});
+}
+
+void Ekf::reset(const Pose& p, double v) {
+  s[X] = p.x;
+  s[Y] = p.y;
+  s[THETA] = p.theta;
+  s[V] = v;
+  s[OMEGA] = 0.0;
+
+  // Placed by hand: pose known to ~1/4 in and ~1 deg, speed to ~1/2 in/s
+  P = Cov{};
+  P(X, X) = P(Y, Y) = 0.0625;
+  P(THETA, THETA) = 3e-4;
+  P(V, V) = 0.25;
+  P(OMEGA, OMEGA) = 1e-3;
+}
+
+void Ekf::shift(double dx, double dy, double dTheta) {
+  s[X] += dx;
+  s[Y] += dy;
+  s[THETA] = wrapRad(s[THETA] + dTheta);
+}
+
+void Ekf::predict(double dt, double accelForward) {
+  if (dt <= 0) return;
+
+  // Position moves along the mid-step heading
+  const double mid = s[THETA] + 0.5 * s[OMEGA] * dt;
+  const double c = std::cos(mid);
+  const double sn = std::sin(mid);
+  const double v = s[V];
+
+  s[X] += v * dt * c;
+  s[Y] += v * dt * sn;
+  s[THETA] = wrapRad(s[THETA] + s[OMEGA] * dt);
+  s[V] += accelForward * dt;
+
+  Cov F = Cov::identity();
+  F(X, THETA) = -v * dt * sn;
+  F(X, V) = dt * c;
+  F(X, OMEGA) = -0.5 * v * dt * dt * sn;
+  F(Y, THETA) = v * dt * c;
+  F(Y, V) = dt * sn;
+  F(Y, OMEGA) = 0.5 * v * dt * dt * c;
+  F(THETA, OMEGA) = dt;
+
+  Cov Q;
+  Q(X, X) = Q(Y, Y) = noise.posIn * noise.posIn * dt;
+  Q(V, V) = noise.accelInPerS2 * noise.accelInPerS2 * dt * dt;
+  Q(OMEGA, OMEGA) = noise.alphaRadPerS2 * noise.alphaRadPerS2 * dt * dt;
+
+  P = F * P * F.transpose() + Q;
+}
+
+bool Ekf::update(State i, double z, double variance, double gateSigma) {
+  double innovation = z - s[i];
+  if (i == THETA) innovation = wrapRad(innovation);
+
+  const double S = P(i, i) + variance;
+  if (S <= 0) return false;
+  if (gateSigma > 0 && innovation * innovation > gateSigma * gateSigma * S) return false;
+
+  // K = P H' / S with H = e_i, so K is column i of P
+  double K[N];
+  for (int r = 0; r < N; r++) K[r] = P(r, i) / S;
+
+  for (int r = 0; r < N; r++) s[r] += K[r] * innovation;
+  s[THETA] = wrapRad(s[THETA]);
+
+  // P -= K (H P) = K * row i of P; then re-symmetrize against rounding
+  Cov next = P;
+  for (int r = 0; r < N; r++)
+    for (int c = 0; c < N; c++) next(r, c) -= K[r] * P(i, c);
+  for (int r = 0; r < N; r++)
+    for (int c = r + 1; c < N; c++) next(r, c) = next(c, r) = 0.5 * (next(r, c) + next(c, r));
+  P = next;
+  return true;
+}
@@ -0,0 +1,411 @@
+#include "localization/mcl.hpp"
+#include "localization/field_map.hpp"
+#include "config/constants.hpp"
+#include "control/executive.hpp"
+#include "control/profiler.hpp"
+#include "hal/rtos.hpp"
+#include <algorithm>
+#include <cmath>
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace {
+  profiler::Section mclStep("mcl.step", 3000);
+
+#if defined(__ARM_NEON)
+  // 1/d: hardware estimate (~8 bits) plus two Newton steps (~23 bits)
+  inline float32x4_t recip(float32x4_t d) {
+    float32x4_t r = vrecpeq_f32(d);
+    r = vmulq_f32(vrecpsq_f32(d, r), r);
+    return vmulq_f32(vrecpsq_f32(d, r), r);
+  }
+#endif
+}
+
+static constexpr std::uint32_t PERIOD_MS = 30;        // V5 distance sensor update rate
+
+// Motion model: odom error per tick, proportional to the motion plus a floor
+// that keeps particles from collapsing onto each other while stopped
+static constexpr float TRANS_NOISE_PER_IN = 0.05f;
+static constexpr float TRANS_NOISE_FLOOR_IN = 0.02f;
+static constexpr float ROT_NOISE_PER_RAD = 0.02f;
+static constexpr float ROT_NOISE_FLOOR_RAD = 0.002f;
+static constexpr float OUTSIDE_PENALTY = 20.0f;       // log-weight for leaving the field
+
+// Sensor model: Gaussian around the expected wall distance, truncated so a
+// robot or game element in front of a sensor costs at most 3 sigma
+static constexpr float MIN_SIGMA_IN = 0.6f;
+static constexpr float SIGMA_FRACTION = 0.05f;        // of the reading
+static constexpr float MAX_PENALTY = 4.5f;
+static constexpr float RAY_EPS = 1e-4f;
+
+static constexpr float GLOBAL_MARGIN_IN = 6.0f;       // random particles keep the robot this far off walls
+static constexpr float GLOBAL_SPAN_IN = 2.0f * ((float)field::HALF_IN - GLOBAL_MARGIN_IN);
+static constexpr double MIN_ERROR_IN = 0.5;           // floor on the reported fix error
+
+// Augmented MCL: short- and long-term averages of the per-tick likelihood.
+// When the short one drops below the long one the particles have stopped
+// explaining the readings (kidnapped, or a global start that missed), and
+// resampling swaps that fraction for random particles. Seeded as if
+// localized (~0.9 in the sim), so a cloud that is wrong from the start
+// injects too.
+static constexpr float W_SLOW_RATE = 0.001f;          // per tick
+static constexpr float W_FAST_RATE = 0.1f;
+static constexpr float W_SEED = 0.5f;
+static constexpr float MIN_INJECT = 0.05f;            // below this, noise in wFast
+static constexpr float MAX_INJECT = 0.25f;
+
+// Roughening after resampling keeps copies of one particle from staying
+// identical: jitter of K * (extent of the set) * N^(-1/3) per dimension
+static constexpr float ROUGHEN_K = 0.2f;
+
+// The estimate is the weighted mean around the best particle; it's only
+// handed to Odom once that neighbourhood holds most of the weight
+static constexpr float MODE_RADIUS_IN = 6.0f;
+static constexpr float MIN_MODE_WEIGHT = 0.8f;
+
+static constexpr int MOUNTS = sizeof(constants::DISTANCE_MOUNTS) / sizeof(constants::DISTANCE_MOUNTS[0]);
+
+static double wrapDeg360(double deg) {
+  deg = std::fmod(deg, 360.0);
+  return deg < 0 ? deg + 360.0 : deg;
+}
+
+Mcl::Mcl(Odom& odom, hal::DistanceIO& sensors)
+  : odom(odom), sensors(sensors), sensorCount(std::min(sensors.count(), MOUNTS)) {
+  applyInit(InitRequest{Pose{0, 0, 0}, 0.0, 0.0, false});
+}
+
+void Mcl::start() {
+  running.store(true);
+  hal::startTask([this]() { this->loop(); }, "Mcl", hal::PRIORITY_LOW);
+}
+
+void Mcl::initAround(const Pose& p, double sigmaIn, double sigmaRad) {
+  const InitRequest req{p, sigmaIn, sigmaRad, false};
+  if (!running.load()) {
+    applyInit(req);
+    return;
+  }
+  initRequest.store(req);
+  initPending.store(true);
+  while (initPending.load()) hal::delay(1);
+}
+
+void Mcl::initGlobal(double thetaRad, double sigmaRad) {
+  const InitRequest req{Pose{0, 0, thetaRad}, 0.0, sigmaRad, true};
+  if (!running.load()) {
+    applyInit(req);
+    return;
+  }
+  initRequest.store(req);
+  initPending.store(true);
+  while (initPending.load()) hal::delay(1);
+}
+
+Mcl::Estimate Mcl::estimate() const {
+  return est.load();
+}
+
+bool Mcl::read(hal::GpsSample& out) const {
+  const Estimate e = est.load();
+  if (!e.valid) return false;
+
+  out.xIn = e.pose.x;
+  out.yIn = e.pose.y;
+  out.headingDeg = wrapDeg360(e.pose.theta * 180.0 / M_PI);
+  out.errorIn = std::max(e.spreadIn, MIN_ERROR_IN);
+  out.timeMs = e.timeMs;
+  return true;
+}
+
+Mcl::Stats Mcl::stats() const {
+  return Stats{updates.load(std::memory_order_relaxed), resamples.load(std::memory_order_relaxed)};
+}
+
+// xorshift32: deterministic, allocation-free, fast enough to draw three
+// numbers per particle per tick
+float Mcl::uniform() {
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return (rng >> 8) * (1.0f / 16777216.0f);
+}
+
+// Irwin-Hall: sum of four uniforms, close enough to normal for motion noise
+// and no log/sqrt/trig
+float Mcl::gaussian(float sigma) {
+  const float sum = uniform() + uniform() + uniform() + uniform();
+  return (sum - 2.0f) * 1.7320508f * sigma;
+}
+
+void Mcl::applyInit(const InitRequest& req) {
+  float* px = xs[cur];
+  float* py = ys[cur];
+  float* pt = thetas[cur];
+
+  for (int i = 0; i < PARTICLES; i++) {
+    if (req.global) {
+      px[i] = (uniform() - 0.5f) * GLOBAL_SPAN_IN;
+      py[i] = (uniform() - 0.5f) * GLOBAL_SPAN_IN;
+    } else {
+      px[i] = (float)req.center.x + gaussian((float)req.sigmaIn);
+      py[i] = (float)req.center.y + gaussian((float)req.sigmaIn);
+    }
+    pt[i] = (float)req.center.theta + gaussian((float)req.sigmaRad);
+    logW[i] = 0.0f;
+  }
+
+  prevSum = PARTICLES;
+  wSlow = W_SEED;
+  wFast = W_SEED;
+  lastOdom = odom.getDeadReckoned().pose;
+  est.store(Estimate{Pose{0, 0, 0}, 0.0, 0, false});
+}
+
+void Mcl::predict(const Pose& delta) {
+  const float fwd = (float)delta.x;
+  const float lat = (float)delta.y;
+  const float turn = (float)std::remainder(delta.theta, 2.0 * M_PI);   // odom may wrap between reads
+  const float sigT = TRANS_NOISE_PER_IN * std::hypot(fwd, lat) + TRANS_NOISE_FLOOR_IN;
+  const float sigR = ROT_NOISE_PER_RAD * std::abs(turn) + ROT_NOISE_FLOOR_RAD;
+
+  float* px = xs[cur];
+  float* py = ys[cur];
+  float* pt = thetas[cur];
+  for (int i = 0; i < PARTICLES; i++) {
+    const float f = fwd + gaussian(sigT);
+    const float l = lat + gaussian(sigT);
+    const float c = std::cos(pt[i]);
+    const float s = std::sin(pt[i]);
+    px[i] += f * c - l * s;
+    py[i] += f * s + l * c;
+    pt[i] += turn + gaussian(sigR);
+
+    cosT[i] = std::cos(pt[i]);
+    sinT[i] = std::sin(pt[i]);
+    if (!field::inside(px[i], py[i])) logW[i] -= OUTSIDE_PENALTY;
+  }
+}
+
+int Mcl::weigh() {
+  int used = 0;
+  for (int k = 0; k < sensorCount; k++) {
+    double z;
+    const hal::DistanceIO::Reading r = sensors.readIn(k, z);
+    if (r == hal::DistanceIO::Reading::INVALID) continue;
+
+    // No return: the wall is past the sensor's range, so only particles
+    // expecting one nearer are wrong
+    const bool noReturn = r == hal::DistanceIO::Reading::NO_RETURN;
+    if (noReturn) z = hal::DistanceIO::MAX_RANGE_IN;
+
+    const constants::DistanceMount& m = constants::DISTANCE_MOUNTS[k];
+    const double a = m.angleDeg * M_PI / 180.0;
+    weighSensor((float)m.xIn, (float)m.yIn, (float)std::cos(a), (float)std::sin(a), (float)z, noReturn);
+    used++;
+  }
+  return used;
+}
+
+// Log-likelihood of one reading for every particle. The ray from the sensor
+// hits x = +-HALF on one axis and y = +-HALF on the other; the nearer wins.
+// With atLeast, z is a lower bound and only shorter predictions cost.
+void Mcl::weighSensor(float mx, float my, float ca, float sa, float z, bool atLeast) {
+  const float sigma = std::max(MIN_SIGMA_IN, SIGMA_FRACTION * z);
+  const float k = 1.0f / (2.0f * sigma * sigma);
+  const float half = (float)field::HALF_IN;
+  const float* px = xs[cur];
+  const float* py = ys[cur];
+
+#if defined(__ARM_NEON)
+  const float32x4_t zero = vdupq_n_f32(0.0f);
+  const float32x4_t posHalf = vdupq_n_f32(half);
+  const float32x4_t negHalf = vdupq_n_f32(-half);
+  const float32x4_t posEps = vdupq_n_f32(RAY_EPS);
+  const float32x4_t negEps = vdupq_n_f32(-RAY_EPS);
+  const float32x4_t reading = vdupq_n_f32(z);
+  const float32x4_t maxPenalty = vdupq_n_f32(MAX_PENALTY);
+
+  for (int i = 0; i < PARTICLES; i += 4) {
+    const float32x4_t c = vld1q_f32(cosT + i);
+    const float32x4_t s = vld1q_f32(sinT + i);
+
+    // Sensor origin and ray direction in the field frame
+    const float32x4_t sx = vmlsq_n_f32(vmlaq_n_f32(vld1q_f32(px + i), c, mx), s, my);
+    const float32x4_t sy = vmlaq_n_f32(vmlaq_n_f32(vld1q_f32(py + i), s, mx), c, my);
+    const float32x4_t dx = vmlsq_n_f32(vmulq_n_f32(c, ca), s, sa);
+    const float32x4_t dy = vmlaq_n_f32(vmulq_n_f32(s, ca), c, sa);
+
+    // Wall each axis heads toward; divisor kept away from zero, same sign
+    const uint32x4_t headX = vcgeq_f32(dx, zero);
+    const uint32x4_t headY = vcgeq_f32(dy, zero);
+    const float32x4_t tx = vmulq_f32(vsubq_f32(vbslq_f32(headX, posHalf, negHalf), sx),
+                                     recip(vbslq_f32(headX, vmaxq_f32(dx, posEps), vminq_f32(dx, negEps))));
+    const float32x4_t ty = vmulq_f32(vsubq_f32(vbslq_f32(headY, posHalf, negHalf), sy),
+                                     recip(vbslq_f32(headY, vmaxq_f32(dy, posEps), vminq_f32(dy, negEps))));
+
+    float32x4_t e = vsubq_f32(reading, vminq_f32(tx, ty));
+    if (atLeast) e = vmaxq_f32(e, zero);
+    const float32x4_t penalty = vminq_f32(vmulq_n_f32(vmulq_f32(e, e), k), maxPenalty);
+    vst1q_f32(logW + i, vsubq_f32(vld1q_f32(logW + i), penalty));
+  }
+#else
+  for (int i = 0; i < PARTICLES; i++) {
+    const float c = cosT[i];
+    const float s = sinT[i];
+    const float sx = px[i] + mx * c - my * s;
+    const float sy = py[i] + mx * s + my * c;
+    const float dx = c * ca - s * sa;
+    const float dy = s * ca + c * sa;
+
+    const float tx = ((dx >= 0 ? half : -half) - sx) / (dx >= 0 ? std::max(dx, RAY_EPS) : std::min(dx, -RAY_EPS));
+    const float ty = ((dy >= 0 ? half : -half) - sy) / (dy >= 0 ? std::max(dy, RAY_EPS) : std::min(dy, -RAY_EPS));
+
+    float e = z - std::min(tx, ty);
+    if (atLeast) e = std::max(e, 0.0f);
+    logW[i] -= std::min(e * e * k, MAX_PENALTY);
+  }
+#endif
+}
+
+// Systematic resampling: one random offset, N evenly spaced picks along the
+// cumulative weights. O(N) and lower variance than N independent draws.
+// Then each pick is either roughened or, with probability inject, moved to
+// a random spot (keeping its heading, which the IMU already knows).
+void Mcl::resample(float inject) {
+  const int next = cur ^ 1;
+  float total = 0.0f;
+  for (int i = 0; i < PARTICLES; i++) total += logW[i];   // logW holds linear weights here
+
+  const float step = total / PARTICLES;
+  float target = uniform() * step;
+  float cumulative = logW[0];
+  int j = 0;
+  for (int i = 0; i < PARTICLES; i++) {
+    while (cumulative < target && j < PARTICLES - 1) cumulative += logW[++j];
+    xs[next][i] = xs[cur][j];
+    ys[next][i] = ys[cur][j];
+    thetas[next][i] = thetas[cur][j];
+    target += step;
+  }
+
+  float lo[3] = {xs[next][0], ys[next][0], thetas[next][0]};
+  float hi[3] = {lo[0], lo[1], lo[2]};
+  for (int i = 1; i < PARTICLES; i++) {
+    const float v[3] = {xs[next][i], ys[next][i], thetas[next][i]};
+    for (int d = 0; d < 3; d++) {
+      lo[d] = std::min(lo[d], v[d]);
+      hi[d] = std::max(hi[d], v[d]);
+    }
+  }
+  const float rough = ROUGHEN_K / std::cbrt((float)PARTICLES);
+  const float sigX = rough * (hi[0] - lo[0]);
+  const float sigY = rough * (hi[1] - lo[1]);
+  const float sigT = rough * (hi[2] - lo[2]);
+
+  for (int i = 0; i < PARTICLES; i++) {
+    if (uniform() < inject) {
+      xs[next][i] = (uniform() - 0.5f) * GLOBAL_SPAN_IN;
+      ys[next][i] = (uniform() - 0.5f) * GLOBAL_SPAN_IN;
+    } else {
+      xs[next][i] += gaussian(sigX);
+      ys[next][i] += gaussian(sigY);
+      thetas[next][i] += gaussian(sigT);
+    }
+  }
+
+  cur = next;
+  for (int i = 0; i < PARTICLES; i++) logW[i] = 0.0f;
+  resamples.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Mcl::publish(std::uint32_t timeMs) {
+  int best = 0;
+  for (int i = 1; i < PARTICLES; i++) if (logW[i] > logW[best]) best = i;
+  const float maxW = logW[best];
+
+  // Weights relative to the best particle so exp() can't underflow them all
+  float sum = 0.0f, sumSq = 0.0f;
+  alignas(16) float w[PARTICLES];
+  for (int i = 0; i < PARTICLES; i++) {
+    w[i] = std::exp(logW[i] - maxW);
+    sum += w[i];
+    sumSq += w[i] * w[i];
+  }
+
+  // The last publish left the linear weights summing to prevSum and each
+  // reading scaled them by its likelihood, so this is the tick's average
+  const float avg = std::exp(maxW) * sum / prevSum;
+  wSlow += W_SLOW_RATE * (avg - wSlow);
+  wFast += W_FAST_RATE * (avg - wFast);
+
+  // Mean of the best particle's neighbourhood; a whole-cloud mean of two
+  // modes would land between them, where neither says the robot is
+  const float bx = xs[cur][best];
+  const float by = ys[cur][best];
+  float modeW = 0.0f;
+  float mx = 0.0f, my = 0.0f, mc = 0.0f, ms = 0.0f;
+  for (int i = 0; i < PARTICLES; i++) {
+    const float ex = xs[cur][i] - bx;
+    const float ey = ys[cur][i] - by;
+    if (ex * ex + ey * ey > MODE_RADIUS_IN * MODE_RADIUS_IN) continue;
+    modeW += w[i];
+    mx += w[i] * xs[cur][i];
+    my += w[i] * ys[cur][i];
+    mc += w[i] * cosT[i];
+    ms += w[i] * sinT[i];
+  }
+  mx /= modeW;
+  my /= modeW;
+
+  float spread = 0.0f;
+  for (int i = 0; i < PARTICLES; i++) {
+    const float ex = xs[cur][i] - mx;
+    const float ey = ys[cur][i] - my;
+    if (ex * ex + ey * ey > MODE_RADIUS_IN * MODE_RADIUS_IN) continue;
+    spread += w[i] * (ex * ex + ey * ey);
+  }
+  spread = std::sqrt(spread / modeW);
+
+  const bool unimodal = modeW >= MIN_MODE_WEIGHT * sum;
+  est.store(Estimate{Pose{mx, my, std::atan2(ms, mc)}, spread, timeMs, unimodal});
+
+  // Resample once half the particles are dead weight (effective sample
+  // size), or to inject when the readings stopped fitting
+  float inject = std::min(MAX_INJECT, 1.0f - wFast / wSlow);
+  if (inject < MIN_INJECT) inject = 0.0f;
+  const float neff = sum * sum / sumSq;
+  if (neff < PARTICLES / 2 || inject > 0.0f) {
+    for (int i = 0; i < PARTICLES; i++) logW[i] = w[i];
+    resample(inject);
+    prevSum = PARTICLES;
+  } else {
+    for (int i = 0; i < PARTICLES; i++) logW[i] -= maxW;
+    prevSum = sum;
+  }
+}
+
+void Mcl::loop() {
+  FixedRate rate("Mcl", PERIOD_MS);
+
+  while (true) {
+    if (initPending.load()) {
+      applyInit(initRequest.load());
+      initPending.store(false);
+    } else {
+      ProfileScope scope(mclStep);
+      const PoseStamped now = odom.getDeadReckoned();
+      predict(relativeTo(lastOdom, now.pose));
+      lastOdom = now.pose;
+
+      if (weigh() > 0) {
+        publish((std::uint32_t)(now.timeUs / 1000));
+        updates.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+
+    rate.wait();
+  }
+}
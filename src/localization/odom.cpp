@@ -1,7 +1,50 @@
 #include "localization/odom.hpp"
 #include "config/constants.hpp"
+#include <algorithm>
 #include <cmath>
-#include "pros/rtos.hpp"
+#include "hal/rtos.hpp"
+#include "control/executive.hpp"
+#include "control/profiler.hpp"
+#include "telemetry/telemetry.hpp"
+
+namespace {
+  telemetry::Channel odomLog("odom", "x,y,theta");
+  telemetry::Channel slipLog("slip", "slipping,velResid,omegaResid");
+  profiler::Section odomStep("odom.step", 2000);
+}
+
+// EKF measurement noise (variances) for motor-encoder mode
+static constexpr double G_IN_PER_S2 = 386.09;
+static constexpr double HEADING_VAR = 1e-6;      // rad^2, IMU heading (~0.06 deg)
+static constexpr double GYRO_VAR = 4e-4;         // (rad/s)^2
+static constexpr double ENC_VEL_VAR = 4.0;       // (in/s)^2, 10ms count quantization
+static constexpr double ENC_OMEGA_VAR = 0.25;    // (rad/s)^2, wheel scrub
+static constexpr double ENC_GATE_SIGMA = 3.0;
+static constexpr int ENC_MAX_REJECTS = 25;       // 250ms
+
+// Slip detection. Entering: encoder acceleration vs the accelerometer,
+// integrated with a leak (so in/s of unexplained wheel speed, not noisy
+// differentiated counts), or encoder yaw rate vs the gyro. Leaving: wheels
+// agree with the IMU-carried velocity again.
+static constexpr double SLIP_LEAK_TAU = 0.25;            // s, bounds accelerometer bias
+static constexpr double SLIP_VEL_IN_PER_S = 6.0;
+static constexpr double SLIP_OMEGA_RAD_PER_S = 1.5;
+static constexpr double SLIP_OMEGA_FRACTION = 0.3;       // of the gyro rate, for scrub in fast turns
+static constexpr double SLIP_EXIT_VEL_IN_PER_S = 3.0;
+static constexpr int SLIP_ENTER_TICKS = 2;
+static constexpr int SLIP_EXIT_TICKS = 10;
+static constexpr double SLIP_VEL_VAR_SCALE = 2500.0;     // encoder velocity weight while slipping (~0.6s to pull V)
+
+// GPS fusion
+static constexpr std::uint32_t GPS_PERIOD_MS = 50;
+static constexpr double GPS_HEADING_VAR = 1.2e-3;   // rad^2 (~2 deg)
+static constexpr double DRIFT_VAR_PER_IN = 0.01;    // in^2 of odom error per inch traveled
+static constexpr double DRIFT_VAR_PER_RAD = 1e-4;   // rad^2 per rad turned
+static constexpr double GPS_GATE_SIGMA = 3.0;
+static constexpr int GPS_MAX_GATE_REJECTS = 20;     // 1s of disagreeing fixes => trust GPS
+static constexpr double BLEND_FRACTION = 0.1;       // of the remaining correction per tick
+static constexpr double BLEND_MAX_IN = 0.05;        // per tick, 5 in/s
+static constexpr double BLEND_MAX_RAD = 0.003;      // per tick, ~17 deg/s
 
 static double degToRad(double deg) {
   return deg * M_PI / 180.0;
@@ -13,60 +56,383 @@ static double wrapRad(double a) {
   return a;
 }
 
-Odom::Odom(Drive& drive) : drive(drive) {}
+Odom::Odom(Drive& drive, hal::TrackingIO* tracking, hal::GpsIO* gps)
+  : drive(drive), tracking(tracking), gps(gps) {}
 
 void Odom::start() {
-  pros::Task([this]() { this->loop(); }, "Odom");
+  running.store(true);
+  hal::startTask([this]() { this->loop(); }, "Odom");
 }
 
 void Odom::reset(Pose p) {
-  x.store(p.x);
-  y.store(p.y);
-  theta.store(p.theta);
+  if (!running.load()) {
+    applyReset(p);
+    return;
+  }
+
+  // Let the odom task apply it between ticks; returns within one period
+  resetPose.store(p);
+  resetPending.store(true);
+  while (resetPending.load()) hal::delay(1);
+}
+
+void Odom::applyReset(const Pose& p) {
+  // IMU heading can't be written, so remember where it sits relative to p
+  headingOffsetRad = p.theta - degToRad(drive.headingDeg());
+
+  captureBaselines();
+  ekf.reset(p);
+  velRejects = 0;
+  if (!usingTracking()) cov.store(ekf.covariance());
+  lastEncVel = 0.0;
+  velResid = 0.0;
+  omegaResid = 0.0;
+  slipTicks = 0;
+  slipping = false;
+
+  historyCount = 0;
+  pending = Pose{0, 0, 0};
+  driftVarIn2 = 0.0;
+  driftVarRad2 = 0.0;
+  gateRejects = 0;
+  relocalize = false;
+  deadReckonedPose = p;
+  pose.store(PoseStamped{p, hal::micros()});
+  deadReckoned.store(PoseStamped{p, hal::micros()});
+}
+
+Ekf::Cov Odom::covariance() const {
+  return cov.load();
+}
+
+PoseStamped Odom::getDeadReckoned() const {
+  return deadReckoned.load();
+}
+
+Odom::SlipStats Odom::slipStats() const {
+  return SlipStats{slipEvents.load(std::memory_order_relaxed), slipMs.load(std::memory_order_relaxed)};
+}
+
+Odom::GpsStats Odom::gpsStats() const {
+  return GpsStats{gpsAccepted.load(std::memory_order_relaxed), gpsRejected.load(std::memory_order_relaxed)};
+}
+
+bool Odom::trackingLost() const {
+  return lostTracking.load(std::memory_order_relaxed);
+}
 
-  // Baseline encoder readings
-  lastLeftDeg = drive.leftMotorDeg();
-  lastRightDeg = drive.rightMotorDeg();
+bool Odom::usingTracking() const {
+  return tracking && !lostTracking.load(std::memory_order_relaxed);
 }
 
 Pose Odom::get() const {
-  return Pose{ x.load(), y.load(), theta.load() };
+  return pose.load().pose;
 }
 
-void Odom::loop() {
-  const int dtMs = 10;
+PoseStamped Odom::getStamped() const {
+  return pose.load();
+}
 
-  // Initialize baselines if not already
-  lastLeftDeg = drive.leftMotorDeg();
-  lastRightDeg = drive.rightMotorDeg();
+void Odom::captureBaselines() {
+  const hal::DriveSample enc = drive.sample();
+  lastLeftDeg = enc.leftDeg;
+  lastRightDeg = enc.rightDeg;
+  lastLeftTimeMs = enc.leftTimeMs;
+  lastRightTimeMs = enc.rightTimeMs;
 
-  while (true) {
-    const double leftDeg = drive.leftMotorDeg();
-    const double rightDeg = drive.rightMotorDeg();
+  if (tracking) {
+    hal::TrackingSample t;
+    lostTracking.store(!tracking->read(t), std::memory_order_relaxed);
+    lastTrackLeftDeg = t.leftDeg;
+    lastTrackRightDeg = t.rightDeg;
+    lastTrackBackDeg = t.backDeg;
+    trackVelIn = 0.0;
+  }
+}
+
+// Picks up from p on motor encoders + IMU, moving at the tracking wheels'
+// last speed so the EKF doesn't gate the encoders out as slip
+void Odom::fallBackToMotors(const Pose& p) {
+  lostTracking.store(true, std::memory_order_relaxed);
+  headingOffsetRad = p.theta - degToRad(drive.headingDeg());
+
+  const hal::DriveSample enc = drive.sample();
+  lastLeftDeg = enc.leftDeg;
+  lastRightDeg = enc.rightDeg;
+  lastLeftTimeMs = enc.leftTimeMs;
+  lastRightTimeMs = enc.rightTimeMs;
+
+  ekf.reset(p, trackVelIn);
+  cov.store(ekf.covariance());
+  velRejects = 0;
+  lastEncVel = trackVelIn;
+  velResid = 0.0;
+  omegaResid = 0.0;
+  slipTicks = 0;
+  slipping = false;
+}
+
+bool Odom::detectSlip(double encVel, double encOmega, double imuAccel, double gyroOmega, double dt) {
+  const double encAccel = (encVel - lastEncVel) / dt;
+  lastEncVel = encVel;
 
-    const double dLeftIn  = constants::motorDegToInches(leftDeg - lastLeftDeg);
-    const double dRightIn = constants::motorDegToInches(rightDeg - lastRightDeg);
-    lastLeftDeg = leftDeg;
-    lastRightDeg = rightDeg;
+  velResid += ((encAccel - imuAccel) - velResid / SLIP_LEAK_TAU) * dt;
+  omegaResid += dt / (SLIP_LEAK_TAU + dt) * ((encOmega - gyroOmega) - omegaResid);
 
-    // Forward distance along robot's forward direction
-    const double dS = (dLeftIn + dRightIn) / 2.0;
+  const double omegaLimit = std::max(SLIP_OMEGA_RAD_PER_S, SLIP_OMEGA_FRACTION * std::abs(gyroOmega));
+  const bool omegaSlip = std::abs(omegaResid) > omegaLimit;
 
-    // Heading from IMU (degrees 0..360) -> radians
-    const double headingRad = degToRad(drive.headingDeg());
+  if (!slipping) {
+    // A couple of ticks over either limit to enter
+    const bool over = omegaSlip || std::abs(velResid) > SLIP_VEL_IN_PER_S;
+    slipTicks = over ? slipTicks + 1 : 0;
+    if (slipTicks >= SLIP_ENTER_TICKS) {
+      slipping = true;
+      slipTicks = 0;
+      slipEvents.fetch_add(1, std::memory_order_relaxed);
+      slipLog.log(1.0f, (float)velResid, (float)omegaResid);
+    }
+  } else {
+    // Steady wheelspin has no acceleration residual, so leaving is judged on
+    // velocity against the IMU-carried EKF state instead
+    slipMs.fetch_add((std::uint32_t)std::lround(dt * 1000.0), std::memory_order_relaxed);
+    const bool agree = !omegaSlip && std::abs(encVel - ekf.velocity()) < SLIP_EXIT_VEL_IN_PER_S;
+    slipTicks = agree ? slipTicks + 1 : 0;
+    if (slipTicks >= SLIP_EXIT_TICKS) {
+      slipping = false;
+      slipTicks = 0;
+      velResid = 0.0;
+      slipLog.log(0.0f, (float)velResid, (float)omegaResid);
+    }
+  }
+  return slipping;
+}
+
+PoseStamped Odom::stepMotors(const PoseStamped& prev) {
+  const hal::DriveSample enc = drive.sample();
+
+  // Motors publish every 10ms; if neither side has a new sample yet, wait for
+  // it rather than integrating a zero step now and a double step next tick
+  if (enc.leftTimeMs == lastLeftTimeMs && enc.rightTimeMs == lastRightTimeMs) return prev;
+
+  const double dtMs = ((double)enc.leftTimeMs + enc.rightTimeMs - lastLeftTimeMs - lastRightTimeMs) / 2.0;
+  const double dt = std::max(dtMs, 1.0) / 1000.0;
+
+  const double dLeftIn  = constants::motorDegToInches(enc.leftDeg - lastLeftDeg);
+  const double dRightIn = constants::motorDegToInches(enc.rightDeg - lastRightDeg);
+  lastLeftDeg = enc.leftDeg;
+  lastRightDeg = enc.rightDeg;
+  lastLeftTimeMs = enc.leftTimeMs;
+  lastRightTimeMs = enc.rightTimeMs;
+
+  const double imuAccel = drive.forwardAccelG() * G_IN_PER_S2;
+  const double gyroOmega = degToRad(drive.yawRateDps());
+  ekf.predict(dt, imuAccel);
+
+  // IMU: absolute heading and gyro rate, both trusted
+  const double headingRad = degToRad(drive.headingDeg()) + headingOffsetRad;
+  ekf.update(Ekf::THETA, headingRad, HEADING_VAR);
+  ekf.update(Ekf::OMEGA, gyroOmega, GYRO_VAR);
+
+  const double encVel = (dLeftIn + dRightIn) / 2.0 / dt;
+  const double encOmega = (dLeftIn - dRightIn) / constants::TRACK_WIDTH_IN / dt;
+
+  if (detectSlip(encVel, encOmega, imuAccel, gyroOmega, dt)) {
+    // Slipping: the IMU carries the state. Encoder velocity still goes in,
+    // heavily down-weighted, so a long push can't integrate accel noise forever.
+    ekf.update(Ekf::V, encVel, ENC_VEL_VAR * SLIP_VEL_VAR_SCALE);
+    velRejects = 0;
+  } else {
+    // Encoders: gated, since slipping wheels over-report. If they disagree for
+    // long enough it's the filter that's wrong (e.g. a hard hit), so give in.
+    if (ekf.update(Ekf::V, encVel, ENC_VEL_VAR, ENC_GATE_SIGMA)) {
+      velRejects = 0;
+    } else if (++velRejects >= ENC_MAX_REJECTS) {
+      ekf.update(Ekf::V, encVel, ENC_VEL_VAR);
+      velRejects = 0;
+    }
+    ekf.update(Ekf::OMEGA, encOmega, ENC_OMEGA_VAR, ENC_GATE_SIGMA);
+  }
 
-    // Use midpoint integration (helps a bit vs simple Euler)
-    const double prevTheta = theta.load();
-    const double midTheta = wrapRad((prevTheta + headingRad) / 2.0);
+  cov.store(ekf.covariance());
+
+  // Stamp with when the encoders were actually read, not when we got to them
+  const std::uint64_t sampleMs = ((std::uint64_t)enc.leftTimeMs + enc.rightTimeMs) / 2;
+  return PoseStamped{ekf.pose(), sampleMs * 1000};
+}
+
+PoseStamped Odom::stepTracking(const PoseStamped& prev) {
+  using namespace constants;
+
+  const std::uint64_t sampleUs = hal::micros();
+  hal::TrackingSample t;
+  if (!tracking->read(t)) {
+    fallBackToMotors(prev.pose);
+    return stepMotors(prev);
+  }
+
+  const double dL = trackingDegToInches(t.leftDeg - lastTrackLeftDeg);
+  const double dR = trackingDegToInches(t.rightDeg - lastTrackRightDeg);
+  const double dB = trackingDegToInches(t.backDeg - lastTrackBackDeg);
+  lastTrackLeftDeg = t.leftDeg;
+  lastTrackRightDeg = t.rightDeg;
+  lastTrackBackDeg = t.backDeg;
+
+  const double spread = TRACKING_LEFT_OFFSET_IN + TRACKING_RIGHT_OFFSET_IN;
+
+  // Left wheel moving further than right = clockwise = +theta
+  const double dTheta = (dL - dR) / spread;
+
+  // Travel of the tracking center; rotation alone cancels out of both
+  const double dForward = (dL * TRACKING_RIGHT_OFFSET_IN + dR * TRACKING_LEFT_OFFSET_IN) / spread;
+  const double dLateral = dB + TRACKING_BACK_OFFSET_IN * dTheta;
+  if (sampleUs > prev.timeUs) trackVelIn = dForward / ((sampleUs - prev.timeUs) / 1e6);
+
+  Pose next = integrateTwist(prev.pose, dForward, dLateral, dTheta);
+  next.theta = wrapRad(next.theta);
+  return PoseStamped{next, sampleUs};
+}
+
+bool Odom::poseAt(std::uint64_t timeUs, Pose& out) const {
+  if (historyCount == 0) return false;
+
+  // Newest first; interpolate between the two entries around timeUs
+  const PoseStamped* newer = nullptr;
+  for (int k = 0; k < historyCount; k++) {
+    const PoseStamped& h = history[(historyHead - 1 - k + HISTORY) % HISTORY];
+    if (h.timeUs <= timeUs) {
+      if (!newer) {
+        out = h.pose;
+        return true;
+      }
+      const double span = (double)(newer->timeUs - h.timeUs);
+      const double t = span > 0 ? (timeUs - h.timeUs) / span : 0.0;
+      out.x = h.pose.x + t * (newer->pose.x - h.pose.x);
+      out.y = h.pose.y + t * (newer->pose.y - h.pose.y);
+      out.theta = wrapRad(h.pose.theta + t * wrapRad(newer->pose.theta - h.pose.theta));
+      return true;
+    }
+    newer = &h;
+  }
+  return false;  // older than anything we kept
+}
+
+bool Odom::fuseGps(const hal::GpsSample& fix, const Pose& current) {
+  if (fix.errorIn > constants::GPS_MAX_ERROR_IN) return false;
+
+  // Where odom thought we were when the fix was taken. History holds
+  // published poses, so add the correction that's still pending to both.
+  Pose then;
+  if (!poseAt((std::uint64_t)fix.timeMs * 1000, then)) return false;
+  const Pose thenEff{then.x + pending.x, then.y + pending.y, then.theta + pending.theta};
+
+  // Scalar Kalman weights: odom drift since the last fix vs sensor error
+  const double gpsVar = fix.errorIn * fix.errorIn;
+  double k = driftVarIn2 / (driftVarIn2 + gpsVar + 1e-9);
+  const double kTheta = driftVarRad2 / (driftVarRad2 + GPS_HEADING_VAR);
+
+  const double ix = fix.xIn - thenEff.x;
+  const double iy = fix.yIn - thenEff.y;
+  const double iTheta = wrapRad(degToRad(fix.headingDeg) - thenEff.theta);
+
+  // Persistent disagreement means odom is the one that's lost (bad reset,
+  // big hit): jump onto the fix instead of weighting against it
+  const double gate = GPS_GATE_SIGMA * GPS_GATE_SIGMA * (driftVarIn2 + gpsVar);
+  if (ix * ix + iy * iy > gate) {
+    if (++gateRejects < GPS_MAX_GATE_REJECTS) return false;
+    k = 1.0;
+    relocalize = true;
+  }
+  gateRejects = 0;
+
+  const Pose corrected{thenEff.x + k * ix, thenEff.y + k * iy, thenEff.theta + kTheta * iTheta};
+
+  // Replay the motion since the fix on top of the corrected pose
+  const Pose replayed = compose(corrected, relativeTo(then, current));
+  pending.x = replayed.x - current.x;
+  pending.y = replayed.y - current.y;
+  pending.theta = wrapRad(replayed.theta - current.theta);
+
+  driftVarIn2 *= (1.0 - k);
+  driftVarRad2 *= (1.0 - kTheta);
+  return true;
+}
+
+PoseStamped Odom::correctGps(const PoseStamped& prev, PoseStamped next) {
+  // Odom error grows with distance traveled and angle turned
+  driftVarIn2 += DRIFT_VAR_PER_IN * std::hypot(next.pose.x - prev.pose.x, next.pose.y - prev.pose.y);
+  driftVarRad2 += DRIFT_VAR_PER_RAD * std::abs(wrapRad(next.pose.theta - prev.pose.theta));
+
+  history[historyHead] = next;
+  historyHead = (historyHead + 1) % HISTORY;
+  historyCount = std::min(historyCount + 1, HISTORY);
+
+  const std::uint32_t now = hal::millis();
+  if (now - lastGpsMs >= GPS_PERIOD_MS) {
+    lastGpsMs = now;
+    hal::GpsSample fix;
+    if (gps->read(fix) && fuseGps(fix, next.pose)) gpsAccepted.fetch_add(1, std::memory_order_relaxed);
+    else gpsRejected.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Bleed in part of the pending correction, rate limited. A relocalization
+  // goes in at once: feet of error would take seconds to blend out.
+  double stepX = BLEND_FRACTION * pending.x;
+  double stepY = BLEND_FRACTION * pending.y;
+  const double stepLen = std::hypot(stepX, stepY);
+  if (stepLen > BLEND_MAX_IN) {
+    stepX *= BLEND_MAX_IN / stepLen;
+    stepY *= BLEND_MAX_IN / stepLen;
+  }
+  double stepTheta = std::clamp(BLEND_FRACTION * pending.theta, -BLEND_MAX_RAD, BLEND_MAX_RAD);
+  if (relocalize) {
+    stepX = pending.x;
+    stepY = pending.y;
+    stepTheta = pending.theta;
+    relocalize = false;
+  }
+
+  pending.x -= stepX;
+  pending.y -= stepY;
+  pending.theta -= stepTheta;
+
+  next.pose.x += stepX;
+  next.pose.y += stepY;
+  next.pose.theta = wrapRad(next.pose.theta + stepTheta);
+
+  // The estimators integrate from their own state; move that too
+  if (!usingTracking()) {
+    ekf.shift(stepX, stepY, stepTheta);
+    headingOffsetRad += stepTheta;
+  }
+  return next;
+}
+
+void Odom::loop() {
+  FixedRate rate("Odom", 10);
+
+  // Initialize baselines if not already
+  captureBaselines();
+
+  while (true) {
+    if (resetPending.load()) {
+      applyReset(resetPose.load());
+      resetPending.store(false);
+    } else {
+      ProfileScope scope(odomStep);
+      const PoseStamped prev = pose.load();
+      PoseStamped next = usingTracking() ? stepTracking(prev) : stepMotors(prev);
 
-    // Update pose in global frame
-    const double newX = x.load() + dS * std::cos(midTheta);
-    const double newY = y.load() + dS * std::sin(midTheta);
+      // Same motion without absolute corrections, for consumers that apply
+      // their own (Mcl)
+      deadReckonedPose = compose(deadReckonedPose, relativeTo(prev.pose, next.pose));
+      deadReckoned.store(PoseStamped{deadReckonedPose, next.timeUs});
 
-    x.store(newX);
-    y.store(newY);
-    theta.store(wrapRad(headingRad));
+      if (gps) next = correctGps(prev, next);
+      pose.store(next);
+      odomLog.log(next.pose.x, next.pose.y, next.pose.theta);
+    }
 
-    pros::delay(dtMs);
+    rate.wait();
   }
 }
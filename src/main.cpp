@@ -1,12 +1,25 @@
 #include "main.h"
 #include "config/ports.hpp"
+#include "config/constants.hpp"
 #include "drive/drive.hpp"
+#include "drive/autotune.hpp"
+#include "drive/sysid.hpp"
 #include "subsystems/devices.hpp"
 #include "auton/auton.hpp"
+#include "auton/script.hpp"
+#include "auton/recorder.hpp"
+#include "hal/rtos.hpp"
+#include "control/executive.hpp"
+#include "control/command.hpp"
+#include "telemetry/telemetry.hpp"
+#include "control/profiler.hpp"
+#include "ui/profiler_screen.hpp"
+#include "ui/selector_screen.hpp"
 #include "pros/llemu.hpp"
 #include "pros/rtos.hpp"
 #include "subsystems/devices.hpp"
 #include "auton/auton.hpp"
+#include <algorithm>
 
 
 /**
@@ -36,12 +49,35 @@ void initialize() {
   pros::lcd::set_text(1, "Calibrating IMU...");
   drive.calibrateImu();
   pros::lcd::set_text(1, "IMU ready");
+
+  // Models/gains from the last Sysid and Autotune runs, if the SD card has them
+  sysid::load(drive);
+  autotune::PoseGains poseGains = motion.poseGains();
+  autotune::load(drive, poseGains);
+  motion.setPoseGains(poseGains);
   
   odom.start();
+  thermal.start();
   odom.reset(Pose{0, 0, 0}); // start at origin
+  if (constants::USE_MCL) {
+    mcl.initAround(Pose{0, 0, 0});
+    mcl.start();
+  }
+
+  // Binary match log on the SD card (silently off without one)
+  telemetry::start();
 
 
+  // Routes from /usd/auton.txt join the selector after the built-in ones.
+  // Bind mechanisms first, e.g. script::bindMechanism("intake", setIntake);
+  if (!script::load() && script::error()[0]) pros::lcd::print(2, "auton.txt %s", script::error());
+
+  // Last driver recording for the "Replay" auton; one made in opcontrol replaces it
+  recorder::load();
+
   auton::initSelector(); // start auton selector task
+  profiler_screen::init(); // loop timings on LCD lines 3-7
+  selector_screen::init(); // touch selector with path preview; "LCD" tile shows the lines above
 }
 
 
@@ -50,7 +86,9 @@ void initialize() {
  * the VEX Competition Switch, following either autonomous or opcontrol. When
  * the robot is enabled, this task will exit.
  */
-void disabled() {}
+void disabled() {
+  motion_command::cancelAll();  // an async move from autonomous outlives its task
+}
 
 /**
  * Runs after initialize(), and before autonomous when connected to the Field
@@ -75,7 +113,12 @@ void competition_initialize() {}
  * from where it left off.
  */
 void autonomous() {
+	thermal.setDeadline(hal::millis() + constants::AUTON_MS);
 	auton::runSelected();
+	profiler::dump(); // timing table to the serial terminal
+	const Odom::SlipStats slip = odom.slipStats();
+	std::printf("odom slip: %u events, %u ms\n", slip.events, slip.slipMs);
+	if (odom.trackingLost()) std::printf("odom: tracking wheel dropped out, ran on motor encoders\n");
 }
 
 /**
@@ -92,10 +135,18 @@ void autonomous() {
  * task, not resume it from where it left off.
  */
 void opcontrol() {
+  motion_command::cancelAll();  // or it keeps driving against the sticks
+
   auto deadband = [](int v, int db = 5) {
     return (std::abs(v) < db) ? 0 : v;
   };
 
+  FixedRate rate("opcontrol", recorder::RATE_MS);
+  bool lastB = false;
+  bool wasRecording = false;
+  bool warnedHot = false;
+  thermal.setDeadline(hal::millis() + constants::DRIVER_MS);
+
   while (true) {
     int forward = master.get_analog(pros::E_CONTROLLER_ANALOG_LEFT_Y);   // -127..127
     int turn    = master.get_analog(pros::E_CONTROLLER_ANALOG_RIGHT_X);  // -127..127
@@ -109,6 +160,43 @@ void opcontrol() {
 
     drive.arcade(forward, turn);
 
-    pros::delay(10);
+    // B starts/stops a driver recording for the "Replay" auton
+    const bool b = master.get_digital(pros::E_CONTROLLER_DIGITAL_B);
+    if (b && !lastB) {
+      if (recorder::recording()) {
+        recorder::stop();
+      } else if (recorder::start(odom.get())) {
+        pros::lcd::set_text(2, "Recording driver...");
+      } else {
+        pros::lcd::set_text(2, "Replay still saving");
+      }
+    }
+    lastB = b;
+
+    // No mechanisms yet; each one gets a bit
+    if (recorder::recording()) {
+      recorder::record(drive.commandedLeftMv(), drive.commandedRightMv(), 0, odom.get());
+    } else if (wasRecording) {
+      // Stopped, or full: the SD write stays off the drive loop
+      hal::startTask([] {
+        const bool saved = recorder::save();
+        pros::lcd::print(2, "Replay %s: %.1f s", saved ? "saved" : "NOT saved",
+                         recorder::frames() * recorder::RATE_MS / 1000.0);
+      }, "Replay Save", hal::PRIORITY_LOW);
+    }
+    wasRecording = recorder::recording();
+
+    // One rumble when the drive is about to throttle; re-arms once it cools
+    const double toLimitS = thermal.timeToLimitS();
+    if (!warnedHot && toLimitS < constants::THERMAL_WARN_S) {
+      const Thermal::Status t = thermal.status();
+      master.rumble("--");
+      master.print(2, 0, "HOT %.0fC %.0fs %.0f%%", std::max(t.left.tempC, t.right.tempC), toLimitS, t.budget * 100);
+      warnedHot = true;
+    } else if (warnedHot && toLimitS > 2 * constants::THERMAL_WARN_S) {
+      warnedHot = false;
+    }
+
+    rate.wait();
   }
 }
\ No newline at end of file
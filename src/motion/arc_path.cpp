@@ -0,0 +1,112 @@
+#include "motion/arc_path.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+  constexpr double MIN_STEP_IN = 1e-6;   // closer samples are duplicates
+
+  double wrapRad(double a) {
+    while (a > M_PI) a -= 2 * M_PI;
+    while (a < -M_PI) a += 2 * M_PI;
+    return a;
+  }
+
+  // Signed curvature of the circle through a, b, c (+ toward +theta)
+  double mengerCurvature(const Waypoint& a, const Waypoint& b, const Waypoint& c) {
+    const double abx = b.x - a.x, aby = b.y - a.y;
+    const double bcx = c.x - b.x, bcy = c.y - b.y;
+    const double cax = a.x - c.x, cay = a.y - c.y;
+    const double denom = std::sqrt((abx * abx + aby * aby) * (bcx * bcx + bcy * bcy) * (cax * cax + cay * cay));
+    if (denom < 1e-12) return 0.0;
+    return 2.0 * (abx * bcy - aby * bcx) / denom;
+  }
+}
+
+ArcPath::ArcPath(const std::vector<Waypoint>& points) {
+  pts.reserve(points.size());
+  for (const Waypoint& p : points) {
+    if (!pts.empty() && std::hypot(p.x - pts.back().x, p.y - pts.back().y) < MIN_STEP_IN) continue;
+    pts.push_back(p);
+  }
+  build();
+}
+
+ArcPath::ArcPath(const PathView& path) : ArcPath(std::vector<Waypoint>(path.pts, path.pts + path.count)) {}
+
+void ArcPath::build() {
+  const int n = (int)pts.size();
+  s.assign(n, 0.0);
+  theta.assign(n, 0.0);
+  curvature.assign(n, 0.0);
+  if (n < 2) return;
+
+  for (int i = 1; i < n; i++) s[i] = s[i - 1] + std::hypot(pts[i].x - pts[i - 1].x, pts[i].y - pts[i - 1].y);
+
+  // Central differences inside, one-sided at the ends
+  for (int i = 0; i < n; i++) {
+    const Waypoint& a = pts[std::max(i - 1, 0)];
+    const Waypoint& b = pts[std::min(i + 1, n - 1)];
+    theta[i] = std::atan2(b.y - a.y, b.x - a.x);
+    if (i > 0) theta[i] = theta[i - 1] + wrapRad(theta[i] - theta[i - 1]);
+  }
+
+  for (int i = 1; i < n - 1; i++) curvature[i] = mengerCurvature(pts[i - 1], pts[i], pts[i + 1]);
+  if (n > 2) {
+    curvature[0] = curvature[1];
+    curvature[n - 1] = curvature[n - 2];
+  }
+}
+
+int ArcPath::segmentAt(double at, double& t) {
+  const int last = (int)s.size() - 2;
+  at = std::clamp(at, 0.0, s.back());
+  int i = std::min(cursor, last);
+
+  if (at < s[i]) {
+    // Gallop back until a sample at or before s, then bisect the bracket
+    int hi = i, step = 1;
+    int lo = i - step;
+    while (lo > 0 && s[lo] > at) {
+      hi = lo;
+      step *= 2;
+      lo = std::max(i - step, 0);
+    }
+    lo = std::max(lo, 0);
+    i = (int)(std::upper_bound(s.begin() + lo, s.begin() + hi + 1, at) - s.begin()) - 1;
+  } else if (at >= s[i + 1] && i < last) {
+    int lo = i + 1, step = 1;
+    int hi = std::min(i + 1 + step, last + 1);
+    while (hi < last + 1 && s[hi] <= at) {
+      lo = hi;
+      step *= 2;
+      hi = std::min(i + 1 + step, last + 1);
+    }
+    i = (int)(std::upper_bound(s.begin() + lo, s.begin() + hi + 1, at) - s.begin()) - 1;
+  }
+
+  i = std::clamp(i, 0, last);
+  cursor = i;
+  t = (at - s[i]) / (s[i + 1] - s[i]);
+  return i;
+}
+
+Pose ArcPath::poseAt(double at) {
+  if (pts.size() < 2) return pts.empty() ? Pose{0, 0, 0} : Pose{pts[0].x, pts[0].y, 0};
+  double t;
+  const int i = segmentAt(at, t);
+  return Pose{pts[i].x + (pts[i + 1].x - pts[i].x) * t,
+              pts[i].y + (pts[i + 1].y - pts[i].y) * t,
+              wrapRad(theta[i] + (theta[i + 1] - theta[i]) * t)};
+}
+
+Waypoint ArcPath::tangentAt(double at) {
+  const double heading = poseAt(at).theta;
+  return Waypoint{std::cos(heading), std::sin(heading)};
+}
+
+double ArcPath::curvatureAt(double at) {
+  if (pts.size() < 2) return 0.0;
+  double t;
+  const int i = segmentAt(at, t);
+  return curvature[i] + (curvature[i + 1] - curvature[i]) * t;
+}
@@ -1,7 +1,18 @@
 #include "motion/motion.hpp"
 #include "config/constants.hpp"
+#include <algorithm>
 #include <cmath>
-#include "pros/rtos.hpp"
+#include "control/executive.hpp"
+#include "control/command.hpp"
+#include "control/profiler.hpp"
+#include "telemetry/telemetry.hpp"
+
+namespace {
+  telemetry::Channel poseLinearLog("poseLinear", "target,current,out,p,i,d");
+  telemetry::Channel poseAngularLog("poseAngular", "target,current,out,p,i,d");
+  telemetry::Channel pursuitLog("followPath", "leftMv,rightMv,remainingIn");
+  profiler::Section pursuitStep("pursuit.step", 2000);
+}
 
 static double wrapRad(double a) {
   while (a > M_PI) a -= 2 * M_PI;
@@ -12,23 +23,26 @@ static double wrapRad(double a) {
 Motion::Motion(Drive& drive, Odom& odom) : drive(drive), odom(odom) {}
 
 void Motion::driveToPoint(double targetX, double targetY) {
-  // Gains (starter). You'll tune on robot.
+  motion_command::claim();
+
   // forwardMv = kP_dist * distError
   // turnMv    = kP_turn * headingError
-  const double kP_dist = 600.0;   // mV per inch
-  const double kP_turn = 4000.0;  // mV per rad
+  const double kP_dist = pose.linear.kP;   // mV per inch
+  const double kP_turn = pose.angular.kP;  // mV per rad
 
-  const int dtMs = 10;
-  const int timeoutMs = 4000;
+  FixedRate rate("driveToPoint", 10);
+  const std::uint32_t timeoutMs = 4000;
 
   const double settleDistIn = 1.0;   // within 1 inch
   const double settleHeadingRad = 0.08; // ~4.5 deg
   const int settleNeeded = 20;        // 200ms
 
   int settleCount = 0;
-  int elapsed = 0;
 
-  while (elapsed < timeoutMs) {
+  const Pose start = odom.get();
+  const double startDist = std::max(std::hypot(targetX - start.x, targetY - start.y), 1e-6);
+
+  while (rate.elapsedMs() < timeoutMs) {
     Pose p = odom.get();
 
     const double dx = targetX - p.x;
@@ -36,6 +50,8 @@ void Motion::driveToPoint(double targetX, double targetY) {
 
     const double dist = std::sqrt(dx*dx + dy*dy);
 
+    if (!motion_command::tick(std::hypot(p.x - start.x, p.y - start.y), 1.0 - dist / startDist)) break;
+
     // Angle to target in global frame
     const double targetAngle = std::atan2(dy, dx);
 
@@ -67,9 +83,143 @@ void Motion::driveToPoint(double targetX, double targetY) {
 
     if (settleCount >= settleNeeded) break;
 
-    pros::delay(dtMs);
-    elapsed += dtMs;
+    rate.wait();
+  }
+
+  drive.setVoltage(0, 0);
+}
+
+void Motion::driveToPose(double targetX, double targetY, double thetaDeg, const PoseParams& params) {
+  motion_command::claim();
+
+  const double targetTheta = thetaDeg * M_PI / 180.0;
+  const double settleHeadingRad = params.settleHeadingDeg * M_PI / 180.0;
+  const int settleNeeded = std::max(1, params.settleMs / 10);
+
+  auto orTuned = [](double v, double tuned) { return std::isnan(v) ? tuned : v; };
+  PID linear(orTuned(params.kLinearP, pose.linear.kP), 0.0, orTuned(params.kLinearD, pose.linear.kD));
+  PID angular(orTuned(params.kAngularP, pose.angular.kP), 0.0, orTuned(params.kAngularD, pose.angular.kD));
+  linear.setLog(&poseLinearLog);
+  angular.setLog(&poseAngularLog);
+
+  FixedRate rate("driveToPose", 10);
+  double dt = rate.periodSec();
+  int settleCount = 0;
+
+  const Pose start = odom.get();
+  const double startDist = std::max(std::hypot(targetX - start.x, targetY - start.y), 1e-6);
+
+  while (rate.elapsedMs() < (std::uint32_t)params.timeoutMs) {
+    Pose p = odom.get();
+
+    const double dist = std::hypot(targetX - p.x, targetY - p.y);
+
+    if (!motion_command::tick(std::hypot(p.x - start.x, p.y - start.y), 1.0 - dist / startDist)) break;
+
+    // Carrot slides from lead*dist behind the target onto it as we close in,
+    // which bends the approach so we arrive along targetTheta
+    const double carrotX = targetX - params.lead * dist * std::cos(targetTheta);
+    const double carrotY = targetY - params.lead * dist * std::sin(targetTheta);
+
+    const bool finalApproach = dist < params.finalApproachIn;
+    const double aimAngle = finalApproach ? targetTheta : std::atan2(carrotY - p.y, carrotX - p.x);
+    const double headingErr = wrapRad(aimAngle - p.theta);
+
+    // Linear error is distance projected on our heading, so it goes negative
+    // (backs up) if we overshoot. Same target=0/current=-err trick as turnTo.
+    const double alongErr = finalApproach
+      ? (targetX - p.x) * std::cos(p.theta) + (targetY - p.y) * std::sin(p.theta)
+      : dist * std::cos(headingErr);
+    double forwardMv = linear.step(0.0, -alongErr, dt);
+    double turnMv = angular.step(0.0, -headingErr, dt);
+
+    turnMv = std::clamp(turnMv, -params.maxMv, params.maxMv);
+    forwardMv = std::clamp(forwardMv, -params.maxMv, params.maxMv);
+
+    // Turning gets priority when the two would saturate a side
+    const double room = params.maxMv - std::abs(turnMv);
+    forwardMv = std::clamp(forwardMv, -room, room);
+
+    drive.setVoltage((int)(forwardMv + turnMv), (int)(forwardMv - turnMv));
+
+    const bool distOk = dist < params.settleDistIn;
+    const bool angOk  = std::abs(wrapRad(targetTheta - p.theta)) < settleHeadingRad;
+
+    if (distOk && angOk) settleCount++;
+    else settleCount = 0;
+
+    if (settleCount >= settleNeeded) break;
+
+    dt = rate.wait();
   }
 
   drive.setVoltage(0, 0);
 }
+
+void Motion::followPath(const std::vector<Waypoint>& waypoints, const PursuitParams& params) {
+  motion_command::claim();
+  const Pose start = odom.get();
+
+  std::vector<Waypoint> path;
+  path.reserve(waypoints.size() + 1);
+  path.push_back(Waypoint{start.x, start.y});
+  path.insert(path.end(), waypoints.begin(), waypoints.end());
+
+  PurePursuit pursuit(std::move(path), params);
+  runPursuit(pursuit, params);
+}
+
+void Motion::followPath(const PathView& path, const PursuitParams& params) {
+  motion_command::claim();
+  PurePursuit pursuit(path, params);
+  runPursuit(pursuit, params);
+}
+
+void Motion::runPursuit(PurePursuit& pursuit, const PursuitParams& params) {
+  const double totalIn = std::max(pursuit.remainingIn(), 1e-6);
+  FixedRate rate("followPath", 10);
+
+  while (rate.elapsedMs() < (std::uint32_t)params.timeoutMs) {
+    double leftMv, rightMv;
+    bool active;
+    {
+      ProfileScope scope(pursuitStep);
+      active = pursuit.step(odom.get(), leftMv, rightMv);
+    }
+    if (!active) break;
+
+    pursuitLog.log(leftMv, rightMv, pursuit.remainingIn());
+
+    const double traveled = totalIn - pursuit.remainingIn();
+    if (!motion_command::tick(traveled, traveled / totalIn)) break;
+
+    drive.setVoltage((int)leftMv, (int)rightMv);
+    rate.wait();
+  }
+
+  drive.setVoltage(0, 0);
+}
+
+MotionHandle Motion::turnToAsync(double targetHeadingDeg) {
+  return motion_command::start([this, targetHeadingDeg]() { drive.turnTo(targetHeadingDeg); });
+}
+
+MotionHandle Motion::driveDistanceAsync(double inches, double headingHoldDeg) {
+  return motion_command::start([this, inches, headingHoldDeg]() { drive.driveDistance(inches, headingHoldDeg); });
+}
+
+MotionHandle Motion::driveToPointAsync(double targetX, double targetY) {
+  return motion_command::start([this, targetX, targetY]() { driveToPoint(targetX, targetY); });
+}
+
+MotionHandle Motion::driveToPoseAsync(double targetX, double targetY, double thetaDeg, const PoseParams& params) {
+  return motion_command::start([=, this]() { driveToPose(targetX, targetY, thetaDeg, params); });
+}
+
+MotionHandle Motion::followPathAsync(const std::vector<Waypoint>& waypoints, const PursuitParams& params) {
+  return motion_command::start([this, waypoints, params]() { followPath(waypoints, params); });
+}
+
+MotionHandle Motion::followPathAsync(const PathView& path, const PursuitParams& params) {
+  return motion_command::start([this, path, params]() { followPath(path, params); });
+}
@@ -0,0 +1,161 @@
+#include "motion/pure_pursuit.hpp"
+#include "config/constants.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+  // Segments checked past the current closest one per tick. Enough for any
+  // speed we reach in 10ms with sane waypoint spacing.
+  constexpr int CLOSEST_WINDOW = 3;
+
+  // Closest parameter t in [0, 1] on segment a->b to point p
+  double projectT(const Waypoint& a, const Waypoint& b, double px, double py) {
+    const double dx = b.x - a.x;
+    const double dy = b.y - a.y;
+    const double len2 = dx*dx + dy*dy;
+    if (len2 < 1e-9) return 0.0;
+    return std::clamp(((px - a.x) * dx + (py - a.y) * dy) / len2, 0.0, 1.0);
+  }
+
+  Waypoint lerp(const Waypoint& a, const Waypoint& b, double t) {
+    return Waypoint{ a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t };
+  }
+
+  double dist2(const Waypoint& a, double px, double py) {
+    return (a.x - px) * (a.x - px) + (a.y - py) * (a.y - py);
+  }
+}
+
+PurePursuit::PurePursuit(std::vector<Waypoint> path, const PursuitParams& params)
+  : owned(path), params(params) {
+  pts = owned.points().data();
+  cumLen = owned.lengths().data();
+  count = owned.size();
+}
+
+PurePursuit::PurePursuit(const PathView& path, const PursuitParams& params)
+  : pts(path.pts), cumLen(path.s), profile(path.velocity), count(path.count),
+    profileMaxVel(path.maxVelInPerS > 0 ? path.maxVelInPerS : 1.0), params(params) {}
+
+double PurePursuit::remainingIn() const {
+  if (count < 2) return 0.0;
+  const double segLen = cumLen[closestSeg + 1] - cumLen[closestSeg];
+  return cumLen[count - 1] - (cumLen[closestSeg] + segLen * closestT);
+}
+
+double PurePursuit::profileAt(int seg, double t) const {
+  return profile[seg] + (profile[seg + 1] - profile[seg]) * t;
+}
+
+void PurePursuit::advanceClosest(double px, double py) {
+  const int lastSeg = count - 2;
+
+  double bestD2 = dist2(lerp(pts[closestSeg], pts[closestSeg + 1], closestT), px, py);
+
+  // Re-project on the current segment, never backwards
+  const double t = std::max(closestT, projectT(pts[closestSeg], pts[closestSeg + 1], px, py));
+  const double d2 = dist2(lerp(pts[closestSeg], pts[closestSeg + 1], t), px, py);
+  if (d2 <= bestD2) {
+    closestT = t;
+    bestD2 = d2;
+  }
+
+  // Then a short window of upcoming segments
+  for (int s = closestSeg + 1; s <= std::min(lastSeg, closestSeg + CLOSEST_WINDOW); s++) {
+    const double ts = projectT(pts[s], pts[s + 1], px, py);
+    const double ds = dist2(lerp(pts[s], pts[s + 1], ts), px, py);
+    if (ds < bestD2) {
+      closestSeg = s;
+      closestT = ts;
+      bestD2 = ds;
+    }
+  }
+}
+
+Waypoint PurePursuit::findLookahead(double px, double py, double lookaheadIn) {
+  const int lastSeg = count - 2;
+
+  // Lookahead is never behind the closest point
+  if (lookSeg < closestSeg || (lookSeg == closestSeg && lookT < closestT)) {
+    lookSeg = closestSeg;
+    lookT = closestT;
+  }
+
+  // Farthest circle/segment intersection ahead of the current lookahead
+  const double r2 = lookaheadIn * lookaheadIn;
+  for (int s = lookSeg; s <= lastSeg; s++) {
+    const Waypoint& a = pts[s];
+    const Waypoint& b = pts[s + 1];
+    const double dx = b.x - a.x;
+    const double dy = b.y - a.y;
+    const double fx = a.x - px;
+    const double fy = a.y - py;
+
+    const double A = dx*dx + dy*dy;
+    if (A < 1e-9) continue;
+    const double B = 2.0 * (fx*dx + fy*dy);
+    const double C = fx*fx + fy*fy - r2;
+    const double disc = B*B - 4.0*A*C;
+    if (disc < 0) break;  // robot is further than lookahead from the path
+
+    const double t2 = (-B + std::sqrt(disc)) / (2.0 * A);
+    const double minT = (s == lookSeg) ? lookT : 0.0;
+    if (t2 >= minT && t2 <= 1.0) {
+      lookSeg = s;
+      lookT = t2;
+      return lerp(a, b, t2);
+    }
+    if (t2 < minT) break;  // circle ends before our current lookahead
+    // t2 > 1: segment end is inside the circle, keep walking
+  }
+
+  // Nothing far enough ahead: aim at the current lookahead, or the end
+  if (dist2(pts[count - 1], px, py) < r2) {
+    lookSeg = lastSeg;
+    lookT = 1.0;
+  }
+  return lerp(pts[lookSeg], pts[lookSeg + 1], lookT);
+}
+
+bool PurePursuit::step(const Pose& pose, double& leftMv, double& rightMv) {
+  leftMv = rightMv = 0.0;
+  if (count < 2) return false;
+
+  advanceClosest(pose.x, pose.y);
+
+  const double remaining = remainingIn();
+  const bool onLastSeg = closestSeg == count - 2;
+  if (onLastSeg && (remaining < params.endToleranceIn || closestT >= 1.0)) return false;
+
+  const double speedFrac = std::clamp(lastSpeedMv / params.maxMv, 0.0, 1.0);
+  const double lookahead = params.minLookaheadIn + (params.maxLookaheadIn - params.minLookaheadIn) * speedFrac;
+  const Waypoint target = findLookahead(pose.x, pose.y, lookahead);
+
+  // Lookahead point in robot frame; lateral is toward +theta
+  const double dx = target.x - pose.x;
+  const double dy = target.y - pose.y;
+  const double forward =  dx * std::cos(pose.theta) + dy * std::sin(pose.theta);
+  const double lateral = -dx * std::sin(pose.theta) + dy * std::cos(pose.theta);
+  const double l2 = std::max(forward*forward + lateral*lateral, 1e-6);
+  const double curvature = 2.0 * lateral / l2;  // 1/in, + = toward +theta
+
+  double speed = params.maxMv;
+  if (std::abs(curvature) > 1e-6) speed = std::min(speed, params.curvatureMvIn / std::abs(curvature));
+  speed = std::min(speed, params.slowdownMvPerIn * remaining);
+  if (profile) speed = std::min(speed, params.maxMv * profileAt(closestSeg, closestT) / profileMaxVel);
+  speed = std::max(speed, params.minMv);
+  lastSpeedMv = speed;
+
+  // Turning toward +theta (clockwise) means the left side runs faster
+  const double half = curvature * constants::TRACK_WIDTH_IN / 2.0;
+  leftMv = speed * (1.0 + half);
+  rightMv = speed * (1.0 - half);
+
+  // Keep the wheel ratio (i.e. the curvature) if a side would saturate
+  const double peak = std::max(std::abs(leftMv), std::abs(rightMv));
+  if (peak > constants::MAX_VOLTAGE) {
+    leftMv *= constants::MAX_VOLTAGE / peak;
+    rightMv *= constants::MAX_VOLTAGE / peak;
+  }
+  return true;
+}
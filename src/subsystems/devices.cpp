@@ -1,16 +1,39 @@
 #include "subsystems/devices.hpp"
 #include "config/ports.hpp"
+#include "hal/v5_drive_io.hpp"
+#include "hal/v5_tracking_io.hpp"
+#include "hal/v5_gps_io.hpp"
+#include "hal/v5_distance_io.hpp"
+#include "config/constants.hpp"
 
 
 pros::Controller master(pros::E_CONTROLLER_MASTER);
 
 // 6-motor drive + IMU
-Drive drive(ports::L1, ports::L2, ports::L3,
-            ports::R1, ports::R2, ports::R3,
-            ports::IMU);
+hal::V5DriveIO driveIO(ports::L1, ports::L2, ports::L3,
+                       ports::R1, ports::R2, ports::R3,
+                       ports::IMU);
+Drive drive(driveIO);
+Thermal thermal(drive);
 
-// Global odometry instance
-Odom odom(drive);
+// Tracking wheels (only read if USE_TRACKING_WHEELS)
+hal::V5TrackingIO trackingIO(ports::TRACK_LEFT, ports::TRACK_RIGHT, ports::TRACK_BACK);
+
+// GPS (only read if USE_GPS)
+hal::V5GpsIO gpsIO(ports::GPS, constants::GPS_X_OFFSET_IN, constants::GPS_Y_OFFSET_IN);
+
+// Distance sensors (only read if USE_MCL)
+hal::V5DistanceIO distanceIO(ports::DIST_FRONT, ports::DIST_LEFT, ports::DIST_RIGHT, ports::DIST_BACK);
+
+// Global odometry instance. Absolute corrections come from the GPS if there
+// is one, else from Mcl (declared in devices.hpp, constructed below).
+Odom odom(drive,
+          constants::USE_TRACKING_WHEELS ? &trackingIO : nullptr,
+          constants::USE_GPS ? static_cast<hal::GpsIO*>(&gpsIO)
+                             : constants::USE_MCL ? static_cast<hal::GpsIO*>(&mcl) : nullptr);
+
+// Monte Carlo localization against the field walls
+Mcl mcl(odom, distanceIO);
 
 // Global motion controller
 Motion motion(drive, odom);
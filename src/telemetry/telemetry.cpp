@@ -0,0 +1,114 @@
+#include "telemetry/telemetry.hpp"
+#include "hal/rtos.hpp"
+#include "util/slot_table.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+  std::atomic<telemetry::Channel*> channels[telemetry::MAX_CHANNELS];
+  std::atomic<bool> active{false};
+  FILE* file = nullptr;
+
+  constexpr std::uint32_t DRAIN_MS = 50;
+  constexpr int FLUSH_EVERY = 20;  // drains, ~1s
+
+  int claimChannelSlot(telemetry::Channel* ch) {
+    return claimSlot(telemetry::MAX_CHANNELS, ch, [](int i) -> std::atomic<telemetry::Channel*>& { return channels[i]; },
+                     [](const telemetry::Channel* a, const telemetry::Channel* b) { return a == b; });
+  }
+
+  void put8(std::uint8_t v) { std::fputc(v, file); }
+
+  void putStr(const char* s) {
+    const std::size_t n = std::min<std::size_t>(std::strlen(s), 255);
+    put8((std::uint8_t)n);
+    std::fwrite(s, 1, n, file);
+  }
+
+  void writerLoop() {
+    bool announced[telemetry::MAX_CHANNELS] = {};
+    int drains = 0;
+
+    while (true) {
+      for (int i = 0; i < telemetry::MAX_CHANNELS; i++) {
+        telemetry::Channel* ch = channels[i].load();
+        if (!ch) continue;
+
+        if (!announced[i]) {
+          put8(telemetry::TAG_CHANNEL);
+          put8((std::uint8_t)i);
+          putStr(ch->name());
+          putStr(ch->fields());
+          announced[i] = true;
+        }
+
+        telemetry::Record r;
+        while (ch->pop(r)) {
+          put8(telemetry::TAG_RECORD);
+          put8((std::uint8_t)i);
+          std::fwrite(&r, sizeof(r), 1, file);
+        }
+
+        const std::uint32_t dropped = ch->takeDropped();
+        if (dropped) {
+          put8(telemetry::TAG_DROPPED);
+          put8((std::uint8_t)i);
+          std::fwrite(&dropped, sizeof(dropped), 1, file);
+        }
+      }
+
+      if (++drains >= FLUSH_EVERY) {
+        std::fflush(file);
+        drains = 0;
+      }
+      hal::delay(DRAIN_MS);
+    }
+  }
+}
+
+static_assert(sizeof(telemetry::Record) == 4 + 4 * telemetry::FIELDS, "Record must be unpadded");
+
+namespace telemetry {
+
+Channel::Channel(const char* name, const char* fields)
+  : nameStr(name), fieldsStr(fields), slot(claimChannelSlot(this)) {}
+
+void Channel::log(float a, float b, float c, float d, float e, float f) {
+  if (!active.load(std::memory_order_relaxed) || slot < 0) return;
+
+  const Record r{ (std::uint32_t)hal::micros(), {a, b, c, d, e, f} };
+  if (!ring.push(r)) dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool start(const char* dir) {
+  if (active.load()) return true;
+
+  // Next unused tlm_NNN.bin so every match keeps its own log
+  char path[64];
+  for (int n = 0; n < 1000; n++) {
+    std::snprintf(path, sizeof(path), "%stlm_%03d.bin", dir, n);
+    FILE* existing = std::fopen(path, "rb");
+    if (!existing) break;
+    std::fclose(existing);
+  }
+
+  file = std::fopen(path, "wb");
+  if (!file) return false;
+
+  const std::uint16_t version = VERSION;
+  const std::uint16_t fields = FIELDS;
+  std::fwrite(MAGIC, 1, sizeof(MAGIC), file);
+  std::fwrite(&version, sizeof(version), 1, file);
+  std::fwrite(&fields, sizeof(fields), 1, file);
+
+  active.store(true);
+  hal::startTask(writerLoop, "Telemetry", hal::PRIORITY_LOW);
+  return true;
+}
+
+bool running() {
+  return active.load();
+}
+
+}
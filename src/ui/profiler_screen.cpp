@@ -0,0 +1,53 @@
+#include "ui/profiler_screen.hpp"
+#include "control/profiler.hpp"
+#include "pros/llemu.hpp"
+#include "pros/rtos.hpp"
+#include <cstdio>
+
+namespace {
+  constexpr int FIRST_LINE = 3;  // 0-1 auton selector, 2 center button
+  constexpr int LINES = 5;
+  constexpr int PAGE_MS = 2000;
+
+  void screenTask(void*) {
+    int page = 0;
+    while (true) {
+      // Collect used slots so pages don't show holes
+      int used[profiler::MAX_SECTIONS];
+      int n = 0;
+      for (int i = 0; i < profiler::MAX_SECTIONS; i++) {
+        profiler::Summary s;
+        if (profiler::summary(i, s)) used[n++] = i;
+      }
+
+      const int pages = n ? (n + LINES - 1) / LINES : 1;
+      page %= pages;
+
+      for (int line = 0; line < LINES; line++) {
+        const int k = page * LINES + line;
+        profiler::Summary s;
+        if (k >= n || !profiler::summary(used[k], s)) {
+          pros::lcd::clear_line(FIRST_LINE + line);
+          continue;
+        }
+        // us; fits the LLEMU line width
+        char text[48];
+        std::snprintf(text, sizeof(text), "%-11.11s %4.0f/%4.0f/%5.0f ov%u",
+                      s.name, s.meanUs, s.p99Us, s.maxUs, s.overruns);
+        pros::lcd::set_text(FIRST_LINE + line, text);
+      }
+
+      page++;
+      pros::delay(PAGE_MS);
+    }
+  }
+}
+
+namespace profiler_screen {
+
+void init() {
+  pros::lcd::register_btn0_cb(profiler::dump);
+  pros::Task(screenTask, nullptr, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "Profiler Screen");
+}
+
+}
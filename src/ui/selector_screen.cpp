@@ -0,0 +1,208 @@
+#include "ui/selector_screen.hpp"
+#include "auton/selector.hpp"
+#include "localization/field_map.hpp"
+#include "pros/llemu.hpp"
+#include "liblvgl/lvgl.h"
+#include <atomic>
+#include <cstdint>
+
+namespace {
+  constexpr int SCREEN_W = 480;
+  constexpr int SCREEN_H = 240;
+  constexpr int MARGIN_PX = 12;
+  constexpr int FIELD_PX = 216;                   // 36 px per tile
+  constexpr double PX_PER_IN = FIELD_PX / (2.0 * field::HALF_IN);
+  constexpr int TILE_PX = FIELD_PX / field::TILES;
+  constexpr int PANEL_X = MARGIN_PX * 2 + FIELD_PX;
+  constexpr int HEADER_H = 32;
+  constexpr int MAX_TILES = 16;                   // 6 built-in + script::MAX_ROUTES, with room
+  constexpr int MAX_PREVIEW = 128;
+  constexpr int POLL_MS = 100;
+
+  const lv_color_t BACKGROUND = lv_color_hex(0x101418);
+  const lv_color_t FOAM = lv_color_hex(0x3a3f44);
+  const lv_color_t SEAM = lv_color_hex(0x55595e);
+  const lv_color_t WALL = lv_color_hex(0xc8ccd0);
+  const lv_color_t ROUTE = lv_color_hex(0xffc400);
+  const lv_color_t SELECTED = lv_color_hex(0x1f9d55);
+  const lv_color_t LOCKED = lv_color_hex(0xb3261e);
+
+  // RGB565 halves the cached layer; the field has no gradients to lose
+  alignas(LV_DRAW_BUF_ALIGN) std::uint8_t fieldBuf[LV_CANVAS_BUF_SIZE(FIELD_PX, FIELD_PX, 16, LV_DRAW_BUF_STRIDE_ALIGN)];
+
+  lv_obj_t* screen = nullptr;
+  lv_obj_t* lcdScreen = nullptr;
+  lv_obj_t* header = nullptr;
+  lv_obj_t* route = nullptr;
+  lv_obj_t* startDot = nullptr;
+  lv_obj_t* tiles[MAX_TILES];
+  int tileCount = 0;
+
+  // lv_line keeps a pointer, so the points live here
+  Waypoint previewPts[MAX_PREVIEW];
+  lv_point_precise_t linePts[MAX_PREVIEW];
+
+  // What the screen shows, so the poll only touches what changed
+  int shownIndex = -1;
+  bool shownLocked = false;
+
+  // The LLEMU button callback isn't on the LVGL task; the poll switches screens
+  std::atomic<bool> backRequested{false};
+
+  lv_value_precise_t toPx(double in) {
+    return (lv_value_precise_t)((in + field::HALF_IN) * PX_PER_IN);
+  }
+
+  void drawLine(lv_layer_t* layer, lv_color_t color, int width, int x1, int y1, int x2, int y2) {
+    lv_draw_line_dsc_t dsc;
+    lv_draw_line_dsc_init(&dsc);
+    dsc.color = color;
+    dsc.width = width;
+    dsc.p1 = lv_point_precise_t{x1, y1};
+    dsc.p2 = lv_point_precise_t{x2, y2};
+    lv_draw_line(layer, &dsc);
+  }
+
+  // Tiles, seams and walls: everything that never changes, drawn once
+  void drawField(lv_obj_t* canvas) {
+    lv_canvas_set_buffer(canvas, fieldBuf, FIELD_PX, FIELD_PX, LV_COLOR_FORMAT_RGB565);
+    lv_canvas_fill_bg(canvas, FOAM, LV_OPA_COVER);
+
+    lv_layer_t layer;
+    lv_canvas_init_layer(canvas, &layer);
+    for (int i = 1; i < field::TILES; i++) {
+      drawLine(&layer, SEAM, 1, i * TILE_PX, 0, i * TILE_PX, FIELD_PX - 1);
+      drawLine(&layer, SEAM, 1, 0, i * TILE_PX, FIELD_PX - 1, i * TILE_PX);
+    }
+
+    lv_draw_rect_dsc_t wall;
+    lv_draw_rect_dsc_init(&wall);
+    wall.bg_opa = LV_OPA_TRANSP;
+    wall.border_color = WALL;
+    wall.border_width = 3;
+    const lv_area_t area{0, 0, FIELD_PX - 1, FIELD_PX - 1};
+    lv_draw_rect(&layer, &wall, &area);
+    lv_canvas_finish_layer(canvas, &layer);
+  }
+
+  // Field frame has +y at +90 deg clockwise, which is screen-down with +x
+  // to the right, so the preview isn't mirrored
+  void showPreview(int index) {
+    const int n = auton_selector::preview(index, previewPts, MAX_PREVIEW);
+    for (int i = 0; i < n; i++) linePts[i] = lv_point_precise_t{toPx(previewPts[i].x), toPx(previewPts[i].y)};
+    lv_line_set_points(route, linePts, n >= 2 ? n : 0);
+
+    if (n >= 1) {
+      lv_obj_set_pos(startDot, MARGIN_PX + (int32_t)linePts[0].x - 4, MARGIN_PX + (int32_t)linePts[0].y - 4);
+      lv_obj_remove_flag(startDot, LV_OBJ_FLAG_HIDDEN);
+    } else {
+      lv_obj_add_flag(startDot, LV_OBJ_FLAG_HIDDEN);
+    }
+  }
+
+  void styleTile(lv_obj_t* tile, bool locked) {
+    lv_obj_set_style_bg_color(tile, locked ? LOCKED : SELECTED, LV_STATE_CHECKED);
+  }
+
+  void onTile(lv_event_t* e) {
+    auton_selector::request((int)(std::intptr_t)lv_event_get_user_data(e));
+  }
+
+  void onLcd(lv_event_t*) {
+    lv_screen_load(lcdScreen);
+  }
+
+  void onCenterButton() {
+    backRequested.store(true);
+  }
+
+  // LVGL timer, so every update after init() runs on the LVGL task
+  void poll(lv_timer_t*) {
+    if (backRequested.exchange(false) && lv_screen_active() != screen) lv_screen_load(screen);
+
+    const int index = auton_selector::selectedIndex();
+    const bool locked = auton_selector::isLocked();
+    if (index == shownIndex && locked == shownLocked) return;
+
+    if (shownIndex >= 0 && shownIndex < tileCount) lv_obj_remove_state(tiles[shownIndex], LV_STATE_CHECKED);
+    if (index < tileCount) {
+      styleTile(tiles[index], locked);
+      lv_obj_add_state(tiles[index], LV_STATE_CHECKED);
+    }
+    if (index != shownIndex) showPreview(index);
+    if (locked != shownLocked || shownIndex < 0) lv_label_set_text(header, locked ? "Auton (LOCKED)" : "Auton");
+
+    shownIndex = index;
+    shownLocked = locked;
+  }
+
+  lv_obj_t* makeButton(lv_obj_t* parent, const char* text, int w, int h) {
+    lv_obj_t* button = lv_button_create(parent);
+    lv_obj_set_size(button, w, h);
+    lv_obj_t* label = lv_label_create(button);
+    lv_label_set_text(label, text);
+    lv_label_set_long_mode(label, LV_LABEL_LONG_DOT);
+    lv_obj_set_width(label, w - 8);
+    lv_obj_center(label);
+    return button;
+  }
+}
+
+namespace selector_screen {
+
+void init() {
+  lcdScreen = lv_screen_active();
+  screen = lv_obj_create(nullptr);
+  lv_obj_set_style_bg_color(screen, BACKGROUND, LV_PART_MAIN);
+  lv_obj_remove_flag(screen, LV_OBJ_FLAG_SCROLLABLE);
+
+  lv_obj_t* canvas = lv_canvas_create(screen);
+  lv_obj_set_pos(canvas, MARGIN_PX, MARGIN_PX);
+  drawField(canvas);
+
+  // Sized to its points, so a new route only invalidates the old and new bounds
+  route = lv_line_create(screen);
+  lv_obj_set_pos(route, MARGIN_PX, MARGIN_PX);
+  lv_obj_set_style_line_color(route, ROUTE, LV_PART_MAIN);
+  lv_obj_set_style_line_width(route, 3, LV_PART_MAIN);
+  lv_obj_set_style_line_rounded(route, true, LV_PART_MAIN);
+
+  startDot = lv_obj_create(screen);
+  lv_obj_set_size(startDot, 9, 9);
+  lv_obj_set_style_radius(startDot, LV_RADIUS_CIRCLE, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(startDot, ROUTE, LV_PART_MAIN);
+  lv_obj_set_style_border_width(startDot, 0, LV_PART_MAIN);
+  lv_obj_add_flag(startDot, LV_OBJ_FLAG_HIDDEN);
+
+  header = lv_label_create(screen);
+  lv_obj_set_pos(header, PANEL_X, MARGIN_PX + 8);
+  lv_obj_set_style_text_color(header, WALL, LV_PART_MAIN);
+
+  lv_obj_t* lcd = makeButton(screen, "LCD", 64, HEADER_H - 4);
+  lv_obj_set_pos(lcd, SCREEN_W - MARGIN_PX - 64, MARGIN_PX);
+  lv_obj_add_event_cb(lcd, onLcd, LV_EVENT_CLICKED, nullptr);
+
+  // Scrolls if the SD card adds more routes than fit
+  lv_obj_t* list = lv_obj_create(screen);
+  lv_obj_set_pos(list, PANEL_X, MARGIN_PX + HEADER_H);
+  lv_obj_set_size(list, SCREEN_W - PANEL_X - MARGIN_PX, SCREEN_H - 2 * MARGIN_PX - HEADER_H);
+  lv_obj_set_style_bg_opa(list, LV_OPA_TRANSP, LV_PART_MAIN);
+  lv_obj_set_style_border_width(list, 0, LV_PART_MAIN);
+  lv_obj_set_style_pad_all(list, 0, LV_PART_MAIN);
+  lv_obj_set_style_pad_gap(list, 6, LV_PART_MAIN);
+  lv_obj_set_flex_flow(list, LV_FLEX_FLOW_ROW_WRAP);
+
+  const int tileW = (SCREEN_W - PANEL_X - MARGIN_PX - 6) / 2;
+  tileCount = auton_selector::count() < MAX_TILES ? auton_selector::count() : MAX_TILES;
+  for (int i = 0; i < tileCount; i++) {
+    tiles[i] = makeButton(list, auton_selector::nameAt(i), tileW, 40);
+    lv_obj_add_event_cb(tiles[i], onTile, LV_EVENT_CLICKED, (void*)(std::intptr_t)i);
+  }
+
+  pros::lcd::register_btn1_cb(onCenterButton);
+  lv_timer_create(poll, POLL_MS, nullptr);
+  poll(nullptr);
+  lv_screen_load(screen);
+}
+
+}
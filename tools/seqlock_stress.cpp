@@ -0,0 +1,92 @@
+// Native SeqLock stress test: one writer, several tight readers.
+//
+//   make seqlock-stress                      (runs it for 3 s)
+//   ./bin/native/seqlock-stress 10 8         (10 s, 8 readers)
+//
+// Every stored payload is self-checking (b[i] == ~a[i], all a[i] equal), so
+// any torn copy shows up as an inconsistent load. Exits non-zero if one
+// does, or if a reader ever sees the sequence go backwards.
+#include "util/seqlock.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace {
+  // Bigger than a cache line, so a copy spans several
+  struct Payload {
+    std::uint32_t a[12];
+    std::uint32_t b[12];
+  };
+
+  Payload make(std::uint32_t n) {
+    Payload p;
+    for (int i = 0; i < 12; i++) {
+      p.a[i] = n;
+      p.b[i] = ~n;
+    }
+    return p;
+  }
+
+  bool consistent(const Payload& p) {
+    for (int i = 0; i < 12; i++) {
+      if (p.a[i] != p.a[0] || p.b[i] != ~p.a[0]) return false;
+    }
+    return true;
+  }
+
+  struct ReaderStats {
+    unsigned long loads = 0;
+    unsigned long torn = 0;
+    unsigned long backwards = 0;
+    std::uint32_t retries = 0;
+  };
+
+  SeqLock<Payload> cell(make(0));
+  std::atomic<bool> stop{false};
+}
+
+int main(int argc, char** argv) {
+  const double seconds = argc > 1 ? std::atof(argv[1]) : 3.0;
+  const int readers = argc > 2 ? std::atoi(argv[2]) : 4;
+  if (seconds <= 0 || readers < 1) {
+    std::fprintf(stderr, "usage: seqlock-stress [seconds] [readers]\n");
+    return 2;
+  }
+
+  std::vector<ReaderStats> stats(readers);
+  std::vector<std::thread> threads;
+  for (int r = 0; r < readers; r++) {
+    threads.emplace_back([&out = stats[r]]() {
+      std::uint32_t last = 0;
+      while (!stop.load(std::memory_order_relaxed)) {
+        const Payload p = cell.load(&out.retries);
+        out.loads++;
+        if (!consistent(p)) out.torn++;
+        else if (p.a[0] < last) out.backwards++;
+        else last = p.a[0];
+      }
+    });
+  }
+
+  unsigned long writes = 0;
+  const auto end = std::chrono::steady_clock::now() + std::chrono::duration<double>(seconds);
+  while (std::chrono::steady_clock::now() < end) {
+    for (int i = 0; i < 1000; i++) cell.store(make((std::uint32_t)++writes));
+  }
+  stop.store(true);
+  for (std::thread& t : threads) t.join();
+
+  ReaderStats total;
+  for (const ReaderStats& s : stats) {
+    total.loads += s.loads;
+    total.torn += s.torn;
+    total.backwards += s.backwards;
+    total.retries += s.retries;
+  }
+  std::printf("%.1f s, %d readers: %lu writes, %lu loads, %u retries, %lu torn, %lu out of order\n",
+              seconds, readers, writes, total.loads, total.retries, total.torn, total.backwards);
+  return total.torn == 0 && total.backwards == 0 ? 0 : 1;
+}
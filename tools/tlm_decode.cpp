@@ -0,0 +1,100 @@
+// Native telemetry decoder: tlm_NNN.bin -> one CSV per channel.
+//
+//   make tlm-decode && ./bin/native/tlm-decode tlm_000.bin out/match1
+//
+// writes out/match1_<channel>.csv with a time_s column plus the channel's fields.
+#include "telemetry/format.hpp"
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+namespace {
+  struct Out {
+    std::string name;
+    int columns = 0;
+    FILE* csv = nullptr;
+    unsigned long records = 0;
+    unsigned long dropped = 0;
+  };
+
+  bool readStr(FILE* f, std::string& s) {
+    const int n = std::fgetc(f);
+    if (n == EOF) return false;
+    s.resize(n);
+    return n == 0 || std::fread(s.data(), 1, n, f) == (size_t)n;
+  }
+}
+
+int main(int argc, char** argv) {
+  if (argc != 3) {
+    std::fprintf(stderr, "usage: tlm-decode <log.bin> <output prefix>\n");
+    return 1;
+  }
+
+  FILE* in = std::fopen(argv[1], "rb");
+  if (!in) {
+    std::perror(argv[1]);
+    return 1;
+  }
+
+  char magic[4];
+  std::uint16_t version = 0, fields = 0;
+  if (std::fread(magic, 1, 4, in) != 4 || std::memcmp(magic, telemetry::MAGIC, 4) != 0 ||
+      std::fread(&version, 2, 1, in) != 1 || std::fread(&fields, 2, 1, in) != 1) {
+    std::fprintf(stderr, "%s: not a telemetry log\n", argv[1]);
+    return 1;
+  }
+  if (version != telemetry::VERSION || fields != telemetry::FIELDS) {
+    std::fprintf(stderr, "%s: unsupported version %u (%u fields)\n", argv[1], version, fields);
+    return 1;
+  }
+
+  Out outs[256];
+  int c;
+  while ((c = std::fgetc(in)) != EOF) {
+    const int id = std::fgetc(in);
+    if (id == EOF) break;
+    Out& o = outs[id];
+
+    if (c == telemetry::TAG_CHANNEL) {
+      std::string fieldNames;
+      if (!readStr(in, o.name) || !readStr(in, fieldNames)) break;
+
+      const std::string path = std::string(argv[2]) + "_" + o.name + ".csv";
+      o.csv = std::fopen(path.c_str(), "w");
+      if (!o.csv) {
+        std::perror(path.c_str());
+        return 1;
+      }
+      std::fprintf(o.csv, "time_s,%s\n", fieldNames.c_str());
+
+      o.columns = 1;
+      for (char ch : fieldNames) if (ch == ',') o.columns++;
+      if (o.columns > telemetry::FIELDS) o.columns = telemetry::FIELDS;
+    } else if (c == telemetry::TAG_RECORD) {
+      telemetry::Record r;
+      if (std::fread(&r, sizeof(r), 1, in) != 1) break;
+      if (!o.csv) continue;  // record without a channel header: corrupt, skip
+
+      // Only as many columns as the channel declared
+      std::fprintf(o.csv, "%.6f", r.timeUs / 1e6);
+      for (int i = 0; i < o.columns; i++) std::fprintf(o.csv, ",%g", r.value[i]);
+      std::fputc('\n', o.csv);
+      o.records++;
+    } else if (c == telemetry::TAG_DROPPED) {
+      std::uint32_t n;
+      if (std::fread(&n, sizeof(n), 1, in) != 1) break;
+      o.dropped += n;
+    } else {
+      std::fprintf(stderr, "bad chunk tag 0x%02x, stopping\n", c);
+      break;
+    }
+  }
+
+  for (auto& o : outs) {
+    if (!o.csv) continue;
+    std::fclose(o.csv);
+    std::printf("%-16s %8lu records %6lu dropped\n", o.name.c_str(), o.records, o.dropped);
+  }
+  return 0;
+}